@@ -222,26 +222,20 @@ GtkWidget *
 nm_network_menu_item_new (NMAccessPoint *ap,
                           guint32 dev_caps,
                           const char *hash,
+                          const char *ssid_utf8,
                           gboolean has_connections,
                           NMApplet *applet)
 {
 	NMNetworkMenuItem *item;
 	NMNetworkMenuItemPrivate *priv;
 	guint32 ap_flags, ap_wpa, ap_rsn;
-	GBytes *ssid;
 
 	item = g_object_new (NM_TYPE_NETWORK_MENU_ITEM, NULL);
 	g_assert (item);
 
 	priv = NM_NETWORK_MENU_ITEM_GET_PRIVATE (item);
 
-	ssid = nm_access_point_get_ssid (ap);
-	if (ssid) {
-		priv->ssid_string = nm_utils_ssid_to_utf8 (g_bytes_get_data (ssid, NULL),
-		                                           g_bytes_get_size (ssid));
-	}
-	if (!priv->ssid_string)
-		priv->ssid_string = g_strdup ("<unknown>");
+	priv->ssid_string = g_strdup (ssid_utf8 ? ssid_utf8 : "<unknown>");
 
 	priv->has_connections = has_connections;
 	priv->hash = g_strdup (hash);
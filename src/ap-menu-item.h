@@ -38,6 +38,7 @@ GType	   nm_network_menu_item_get_type (void) G_GNUC_CONST;
 GtkWidget* nm_network_menu_item_new (NMAccessPoint *ap,
                                      guint32 dev_caps,
                                      const char *hash,
+                                     const char *ssid_utf8,
                                      gboolean has_connections,
                                      NMApplet *applet);
 
@@ -320,53 +320,138 @@ static const char *manf_default_ssids[] = {
 	NULL
 };
 
+/* List known trojan networks that should never be shown to the user */
+static const char *denylisted_ssids[] = {
+	/* http://www.npr.org/templates/story/story.php?storyId=130451369 */
+	"Free Public Wi-Fi",
+	NULL
+};
+
+static GHashTable *
+ssid_set_new (const char **list)
+{
+	GHashTable *set;
+
+	set = g_hash_table_new_full (g_bytes_hash, g_bytes_equal,
+	                             (GDestroyNotify) g_bytes_unref, NULL);
+	for (; *list; list++)
+		g_hash_table_add (set, g_bytes_new_static (*list, strlen (*list)));
+	return set;
+}
+
 static gboolean
-is_ssid_in_list (GBytes *ssid, const char **list)
+is_ssid_in_set (GBytes *ssid, GHashTable **set, const char **list)
 {
-	while (*list) {
-		if (g_bytes_get_size (ssid) == strlen (*list)) {
-			if (!memcmp (*list, g_bytes_get_data (ssid, NULL), g_bytes_get_size (ssid)))
-				return TRUE;
-		}
-		list++;
-	}
-	return FALSE;
+	if (G_UNLIKELY (!*set))
+		*set = ssid_set_new (list);
+	return g_hash_table_contains (*set, ssid);
 }
 
 static gboolean
 is_manufacturer_default_ssid (GBytes *ssid)
 {
-	return is_ssid_in_list (ssid, manf_default_ssids);
+	static GHashTable *set = NULL;
+
+	return is_ssid_in_set (ssid, &set, manf_default_ssids);
 }
 
-static char *
-get_ssid_utf8 (NMAccessPoint *ap)
+static gboolean
+is_denylisted_ssid (GBytes *ssid)
+{
+	static GHashTable *set = NULL;
+
+	return is_ssid_in_set (ssid, &set, denylisted_ssids);
+}
+
+/*****************************************************************************/
+
+struct ap_notification_data;
+
+/* Per-AP data derived from the AP's SSID and security properties.  It's
+ * computed when the AP shows up or its properties change, so that building
+ * the menu doesn't have to convert or classify SSIDs over and over.
+ */
+typedef struct {
+	char *hash;
+	char *ssid_utf8;
+	gboolean hidden;
+	gboolean denylisted;
+	gboolean manf_default;
+
+	/* The device's "networks available" counters this AP belongs to, and
+	 * the ones it's currently accounted in (if any)
+	 */
+	struct ap_notification_data *owner;
+	struct ap_notification_data *counted;
+	gboolean counted_known;
+} ApInfo;
+
+#define AP_INFO_TAG "ap-info"
+
+static void
+ap_info_free (ApInfo *info)
+{
+	g_free (info->hash);
+	g_free (info->ssid_utf8);
+	g_slice_free (ApInfo, info);
+}
+
+static void
+ap_info_update_ssid (ApInfo *info, NMAccessPoint *ap)
 {
-	char *ssid_utf8 = NULL;
 	GBytes *ssid;
 
-	if (ap) {
-		ssid = nm_access_point_get_ssid (ap);
-		if (ssid)
-			ssid_utf8 = nm_utils_ssid_to_utf8 (g_bytes_get_data (ssid, NULL), g_bytes_get_size (ssid));
-	}
-	if (!ssid_utf8)
-		ssid_utf8 = g_strdup (_("(none)"));
+	g_clear_pointer (&info->ssid_utf8, g_free);
+	info->hidden = TRUE;
+	info->denylisted = FALSE;
+	info->manf_default = FALSE;
 
-	return ssid_utf8;
+	ssid = nm_access_point_get_ssid (ap);
+	if (!ssid)
+		return;
+
+	info->ssid_utf8 = nm_utils_ssid_to_utf8 (g_bytes_get_data (ssid, NULL), g_bytes_get_size (ssid));
+	info->hidden = nm_utils_is_empty_ssid (g_bytes_get_data (ssid, NULL), g_bytes_get_size (ssid));
+	info->denylisted = is_denylisted_ssid (ssid);
+	info->manf_default = is_manufacturer_default_ssid (ssid);
 }
 
-/* List known trojan networks that should never be shown to the user */
-static const char *denylisted_ssids[] = {
-	/* http://www.npr.org/templates/story/story.php?storyId=130451369 */
-	"Free Public Wi-Fi",
-	NULL
-};
+static void
+ap_info_update_hash (ApInfo *info, NMAccessPoint *ap)
+{
+	g_free (info->hash);
+	info->hash = utils_hash_ap (nm_access_point_get_ssid (ap),
+	                            nm_access_point_get_mode (ap),
+	                            nm_access_point_get_flags (ap),
+	                            nm_access_point_get_wpa_flags (ap),
+	                            nm_access_point_get_rsn_flags (ap));
+}
 
-static gboolean
-is_denylisted_ssid (GBytes *ssid)
+static ApInfo *
+ap_info_get (NMAccessPoint *ap)
 {
-	return is_ssid_in_list (ssid, denylisted_ssids);
+	ApInfo *info;
+
+	info = g_object_get_data (G_OBJECT (ap), AP_INFO_TAG);
+	if (!info) {
+		info = g_slice_new0 (ApInfo);
+		ap_info_update_ssid (info, ap);
+		ap_info_update_hash (info, ap);
+		g_object_set_data_full (G_OBJECT (ap), AP_INFO_TAG,
+		                        info, (GDestroyNotify) ap_info_free);
+	}
+	return info;
+}
+
+static char *
+get_ssid_utf8 (NMAccessPoint *ap)
+{
+	const char *ssid_utf8 = NULL;
+
+	if (ap)
+		ssid_utf8 = ap_info_get (ap)->ssid_utf8;
+
+	return g_strdup (ssid_utf8 ? ssid_utf8 : _("(none)"));
 }
 
 static void
@@ -486,7 +571,7 @@ wifi_new_auto_connection (NMDevice *device,
 
 	ssid = nm_access_point_get_ssid (ap);
 	if (   (nm_access_point_get_mode (ap) == NM_802_11_MODE_INFRA)
-	    && (is_manufacturer_default_ssid (ssid) == TRUE)) {
+	    && ap_info_get (ap)->manf_default) {
 
 		/* Lock connection to this AP if it's a manufacturer-default SSID
 		 * so that we don't randomly connect to some other 'linksys'
@@ -578,7 +663,8 @@ wifi_menu_item_activate (GtkMenuItem *item, gpointer user_data)
 struct dup_data {
 	NMDevice *device;
 	NMNetworkMenuItem *found;
-	char *hash;
+	const char *hash;
+	const char *ssid_utf8;
 };
 
 static void
@@ -625,6 +711,7 @@ create_new_ap_item (NMDeviceWifi *device,
 	item = nm_network_menu_item_new (ap,
 	                                 nm_device_wifi_get_capabilities (device),
 	                                 dup_data->hash,
+	                                 dup_data->ssid_utf8,
 	                                 ap_connections->len != 0,
 	                                 applet);
 	g_object_set_data (G_OBJECT (item), "device", NM_DEVICE (device));
@@ -691,14 +778,12 @@ get_menu_item_for_ap (NMDeviceWifi *device,
                       GSList *menu_list,
                       NMApplet *applet)
 {
-	GBytes *ssid;
+	ApInfo *info;
 	struct dup_data dup_data = { NULL, NULL };
 
 	/* Don't add BSSs that hide their SSID or are denylisted */
-	ssid = nm_access_point_get_ssid (ap);
-	if (   !ssid
-	    || nm_utils_is_empty_ssid (g_bytes_get_data (ssid, NULL), g_bytes_get_size (ssid))
-	    || is_denylisted_ssid (ssid))
+	info = ap_info_get (ap);
+	if (info->hidden || info->denylisted)
 		return NULL;
 
 	/* Find out if this AP is a member of a larger network that all uses the
@@ -707,7 +792,8 @@ get_menu_item_for_ap (NMDeviceWifi *device,
 	 * menu item's duplicate list.
 	 */
 	dup_data.found = NULL;
-	dup_data.hash = g_object_get_data (G_OBJECT (ap), "hash");
+	dup_data.hash = info->hash;
+	dup_data.ssid_utf8 = info->ssid_utf8;
 	g_return_val_if_fail (dup_data.hash != NULL, NULL);
 
 	dup_data.device = NM_DEVICE (device);
@@ -968,49 +1054,110 @@ notify_active_ap_changed_cb (NMDeviceWifi *device,
 	applet_schedule_update_icon (applet);
 }
 
+struct ap_notification_data 
+{
+	NMApplet *applet;
+	NMDeviceWifi *device;
+	guint id;
+	gulong last_notification_time;
+	guint new_con_id;
+
+	/* Connections for this device, valid as of applet->connections_gen */
+	GPtrArray *connections;
+	guint connections_gen;
+
+	/* Number of APs with and without an autoconnect connection */
+	guint n_known;
+	guint n_unknown;
+};
+
+static gboolean
+ap_has_autoconnect_connection (NMAccessPoint *ap, const GPtrArray *connections)
+{
+	GPtrArray *ap_connections;
+	gboolean is_autoconnect = FALSE;
+	int i;
+
+	ap_connections = nm_access_point_filter_connections (ap, connections);
+	for (i = 0; i < ap_connections->len; i++) {
+		NMConnection *connection = NM_CONNECTION (ap_connections->pdata[i]);
+		NMSettingConnection *s_con;
+
+		s_con = nm_connection_get_setting_connection (connection);
+		if (nm_setting_connection_get_autoconnect (s_con)) {
+			is_autoconnect = TRUE;
+			break;
+		}
+	}
+	g_ptr_array_unref (ap_connections);
+
+	return is_autoconnect;
+}
+
 static void
-add_hash_to_ap (NMAccessPoint *ap)
+ap_uncount (NMAccessPoint *ap)
 {
-	char *hash;
+	ApInfo *info = ap_info_get (ap);
+	struct ap_notification_data *data = info->counted;
+
+	if (!data)
+		return;
 
-	hash = utils_hash_ap (nm_access_point_get_ssid (ap),
-	                      nm_access_point_get_mode (ap),
-	                      nm_access_point_get_flags (ap),
-	                      nm_access_point_get_wpa_flags (ap),
-	                      nm_access_point_get_rsn_flags (ap));
-	g_object_set_data_full (G_OBJECT (ap), "hash", hash, (GDestroyNotify) g_free);
+	if (info->counted_known)
+		data->n_known--;
+	else
+		data->n_unknown--;
+	info->counted = NULL;
 }
 
 static void
-notify_ap_prop_changed_cb (NMAccessPoint *ap,
-                           GParamSpec *pspec,
-                           NMApplet *applet)
+ap_count (struct ap_notification_data *data, NMAccessPoint *ap)
 {
-	const char *prop = g_param_spec_get_name (pspec);
+	ApInfo *info = ap_info_get (ap);
 
-	if (   !strcmp (prop, NM_ACCESS_POINT_FLAGS)
-	    || !strcmp (prop, NM_ACCESS_POINT_WPA_FLAGS)
-	    || !strcmp (prop, NM_ACCESS_POINT_RSN_FLAGS)
-	    || !strcmp (prop, NM_ACCESS_POINT_SSID)
-	    || !strcmp (prop, NM_ACCESS_POINT_FREQUENCY)
-	    || !strcmp (prop, NM_ACCESS_POINT_MODE)) {
-		add_hash_to_ap (ap);
-	}
+	ap_uncount (ap);
+
+	info->owner = data;
+	if (!nm_access_point_get_ssid (ap))
+		return;
+
+	info->counted = data;
+	info->counted_known = ap_has_autoconnect_connection (ap, data->connections);
+	if (info->counted_known)
+		data->n_known++;
+	else
+		data->n_unknown++;
 }
 
-struct ap_notification_data 
+/* Recount all APs of the device if the connections changed since the
+ * last time; otherwise the counters are kept up to date as APs come and go.
+ */
+static void
+ap_counts_sync (struct ap_notification_data *data)
 {
-	NMApplet *applet;
-	NMDeviceWifi *device;
-	guint id;
-	gulong last_notification_time;
-	guint new_con_id;
-};
+	GPtrArray *all_connections;
+	const GPtrArray *aps;
+	int i;
+
+	if (data->connections && data->connections_gen == data->applet->connections_gen)
+		return;
+
+	if (data->connections)
+		g_ptr_array_unref (data->connections);
+	all_connections = applet_get_connections_for_device_type (data->applet, NM_DEVICE_TYPE_WIFI);
+	data->connections = nm_device_filter_connections (NM_DEVICE (data->device), all_connections);
+	data->connections_gen = data->applet->connections_gen;
+	g_ptr_array_unref (all_connections);
+
+	aps = nm_device_wifi_get_access_points (data->device);
+	for (i = 0; aps && (i < aps->len); i++)
+		ap_count (data, aps->pdata[i]);
+}
 
-/* Scan the list of access points, looking for the case where we have no
- * known (i.e. autoconnect) access points, but we do have unknown ones.
+/* Check whether we have no known (i.e. autoconnect) access points, but we
+ * do have unknown ones.
  * 
- * If we find one, notify the user.
+ * If so, notify the user.
  */
 static gboolean
 idle_check_avail_access_point_notification (gpointer datap)
@@ -1018,13 +1165,7 @@ idle_check_avail_access_point_notification (gpointer datap)
 	struct ap_notification_data *data = datap;
 	NMApplet *applet = data->applet;
 	NMDeviceWifi *device = data->device;
-	int i;
-	const GPtrArray *aps;
-	GPtrArray *all_connections;
-	GPtrArray *connections;
 	GTimeVal timeval;
-	gboolean have_unused_access_point = FALSE;
-	gboolean have_no_autoconnect_points = TRUE;
 
 	data->id = 0;
 
@@ -1038,42 +1179,8 @@ idle_check_avail_access_point_notification (gpointer datap)
 	if ((timeval.tv_sec - data->last_notification_time) < 60*60) /* Notify at most once an hour */
 		return FALSE;	
 
-	all_connections = applet_get_all_connections (applet);
-	connections = nm_device_filter_connections (NM_DEVICE (device), all_connections);
-	g_ptr_array_unref (all_connections);	
-
-	aps = nm_device_wifi_get_access_points (device);
-	for (i = 0; i < aps->len; i++) {
-		NMAccessPoint *ap = aps->pdata[i];
-		GPtrArray *ap_connections;
-		int a;
-		gboolean is_autoconnect = FALSE;
-
-		if (!nm_access_point_get_ssid (ap))
-			continue;
-
-		ap_connections = nm_access_point_filter_connections (ap, connections);
-
-		for (a = 0; a < ap_connections->len; a++) {
-			NMConnection *connection = NM_CONNECTION (ap_connections->pdata[a]);
-			NMSettingConnection *s_con;
-
-			s_con = nm_connection_get_setting_connection (connection);
-			if (nm_setting_connection_get_autoconnect (s_con))  {
-				is_autoconnect = TRUE;
-				break;
-			}
-		}
-		g_ptr_array_unref (ap_connections);
-
-		if (!is_autoconnect)
-			have_unused_access_point = TRUE;
-		else
-			have_no_autoconnect_points = FALSE;
-	}
-	g_ptr_array_unref (connections);
-
-	if (!(have_unused_access_point && have_no_autoconnect_points))
+	ap_counts_sync (data);
+	if (!(data->n_unknown > 0 && data->n_known == 0))
 		return FALSE;
 
 	/* Avoid notifying too often */
@@ -1105,19 +1212,59 @@ queue_avail_access_point_notification (NMDevice *device)
 	data->id = g_timeout_add_seconds (3, idle_check_avail_access_point_notification, data);
 }
 
+static void
+notify_ap_prop_changed_cb (NMAccessPoint *ap,
+                           GParamSpec *pspec,
+                           NMApplet *applet)
+{
+	const char *prop = g_param_spec_get_name (pspec);
+	ApInfo *info = ap_info_get (ap);
+
+	if (!strcmp (prop, NM_ACCESS_POINT_SSID))
+		ap_info_update_ssid (info, ap);
+
+	/* Whether a connection matches the AP also depends on its security
+	 * and mode, so any of these can move it between known and unknown. */
+	if (   info->owner
+	    && (   !strcmp (prop, NM_ACCESS_POINT_SSID)
+	        || !strcmp (prop, NM_ACCESS_POINT_FLAGS)
+	        || !strcmp (prop, NM_ACCESS_POINT_WPA_FLAGS)
+	        || !strcmp (prop, NM_ACCESS_POINT_RSN_FLAGS)
+	        || !strcmp (prop, NM_ACCESS_POINT_MODE))) {
+		struct ap_notification_data *data = info->owner;
+
+		ap_counts_sync (data);
+		ap_count (data, ap);
+	}
+
+	if (   !strcmp (prop, NM_ACCESS_POINT_FLAGS)
+	    || !strcmp (prop, NM_ACCESS_POINT_WPA_FLAGS)
+	    || !strcmp (prop, NM_ACCESS_POINT_RSN_FLAGS)
+	    || !strcmp (prop, NM_ACCESS_POINT_SSID)
+	    || !strcmp (prop, NM_ACCESS_POINT_FREQUENCY)
+	    || !strcmp (prop, NM_ACCESS_POINT_MODE)) {
+		ap_info_update_hash (info, ap);
+	}
+}
+
 static void
 access_point_added_cb (NMDeviceWifi *device,
                        NMAccessPoint *ap,
                        gpointer user_data)
 {
 	NMApplet *applet = NM_APPLET  (user_data);
+	struct ap_notification_data *data;
 
-	add_hash_to_ap (ap);
+	ap_info_get (ap);
 	g_signal_connect (G_OBJECT (ap),
 	                  "notify",
 	                  G_CALLBACK (notify_ap_prop_changed_cb),
 	                  applet);
 
+	data = g_object_get_data (G_OBJECT (device), "notify-wifi-avail-data");
+	ap_counts_sync (data);
+	ap_count (data, ap);
+
 	queue_avail_access_point_notification (NM_DEVICE (device));
 	applet_schedule_update_menu (applet);
 }
@@ -1130,6 +1277,9 @@ access_point_removed_cb (NMDeviceWifi *device,
 	NMApplet *applet = NM_APPLET  (user_data);
 	NMAccessPoint *old;
 
+	ap_uncount (ap);
+	ap_info_get (ap)->owner = NULL;
+
 	/* If this AP was the active AP, make sure ACTIVE_AP_TAG gets cleared from
 	 * its device.
 	 */
@@ -1156,9 +1306,19 @@ free_ap_notification_data (gpointer user_data)
 {
 	struct ap_notification_data *data = user_data;
 	NMClient *client = data->applet->nm_client;
+	const GPtrArray *aps;
+	int i;
 
 	nm_clear_g_source (&data->id);
 
+	aps = nm_device_wifi_get_access_points (data->device);
+	for (i = 0; aps && (i < aps->len); i++) {
+		ap_uncount (aps->pdata[i]);
+		ap_info_get (aps->pdata[i])->owner = NULL;
+	}
+	if (data->connections)
+		g_ptr_array_unref (data->connections);
+
 	if (client)
 		g_signal_handler_disconnect (client, data->new_con_id);
 	memset (data, 0, sizeof (*data));
@@ -1212,7 +1372,7 @@ wifi_device_added (NMDevice *device, NMApplet *applet)
 	/* Hash all APs this device knows about */
 	aps = nm_device_wifi_get_access_points (wdev);
 	for (i = 0; aps && (i < aps->len); i++)
-		add_hash_to_ap (g_ptr_array_index (aps, i));
+		ap_info_get (g_ptr_array_index (aps, i));
 }
 
 static NMAccessPoint *
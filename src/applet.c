@@ -302,76 +302,226 @@ applet_get_default_active_connection (NMApplet *applet, NMDevice **device,
 	return default_ac;
 }
 
-GPtrArray *
-applet_get_all_connections (NMApplet *applet)
+static gboolean
+connection_is_vpn (NMConnection *connection)
+{
+	return    nm_connection_is_type (connection, NM_SETTING_VPN_SETTING_NAME)
+	       || nm_connection_is_type (connection, NM_SETTING_WIREGUARD_SETTING_NAME);
+}
+
+static NMDeviceType
+connection_get_device_type (NMConnection *connection)
+{
+	const char *ctype;
+
+	ctype = nm_connection_get_connection_type (connection);
+	if (!ctype)
+		return NM_DEVICE_TYPE_UNKNOWN;
+
+	if (!strcmp (ctype, NM_SETTING_WIRED_SETTING_NAME) || !strcmp (ctype, NM_SETTING_PPPOE_SETTING_NAME))
+		return NM_DEVICE_TYPE_ETHERNET;
+	else if (!strcmp (ctype, NM_SETTING_WIRELESS_SETTING_NAME))
+		return NM_DEVICE_TYPE_WIFI;
+	else if (!strcmp (ctype, NM_SETTING_GSM_SETTING_NAME) || !strcmp (ctype, NM_SETTING_CDMA_SETTING_NAME))
+		return NM_DEVICE_TYPE_MODEM;
+	else if (!strcmp (ctype, NM_SETTING_BLUETOOTH_SETTING_NAME))
+		return NM_DEVICE_TYPE_BT;
+	return NM_DEVICE_TYPE_UNKNOWN;
+}
+
+static int
+sort_vpn_connections (gconstpointer a, gconstpointer b)
+{
+	NMConnection **ca = (NMConnection **) a;
+	NMConnection **cb = (NMConnection **) b;
+
+	return strcmp (nm_connection_get_id (NM_CONNECTION (*ca)), nm_connection_get_id (NM_CONNECTION (*cb)));
+}
+
+static void
+connections_snapshot_clear (NMApplet *applet)
+{
+	g_clear_pointer (&applet->connections_all, g_ptr_array_unref);
+	g_clear_pointer (&applet->connections_vpn, g_ptr_array_unref);
+	g_clear_pointer (&applet->connections_by_type, g_hash_table_unref);
+}
+
+/* Rebuild the connection snapshot if any connection was added, removed
+ * or changed since it was last taken.
+ */
+static void
+connections_snapshot_sync (NMApplet *applet)
 {
 	const GPtrArray *all_connections;
-	GPtrArray *connections;
 	int i;
-	NMConnection *connection;
-	NMSettingConnection *s_con;
+
+	if (   applet->connections_all
+	    && applet->connections_snapshot_gen == applet->connections_gen)
+		return;
+
+	connections_snapshot_clear (applet);
 
 	all_connections = nm_client_get_connections (applet->nm_client);
-	connections = g_ptr_array_new_full (all_connections->len, g_object_unref);
+	applet->connections_all = g_ptr_array_new_full (all_connections->len, g_object_unref);
+	applet->connections_vpn = g_ptr_array_new_with_free_func (g_object_unref);
+	applet->connections_by_type = g_hash_table_new_full (NULL, NULL, NULL,
+	                                                     (GDestroyNotify) g_ptr_array_unref);
+	applet->connections_snapshot_gen = applet->connections_gen;
 
 	/* Ignore port connections unless they are wifi connections */
 	for (i = 0; i < all_connections->len; i++) {
-		connection = all_connections->pdata[i];
+		NMConnection *connection = all_connections->pdata[i];
+		NMSettingConnection *s_con;
+		NMDeviceType type;
+		GPtrArray *subset;
 
 		s_con = nm_connection_get_setting_connection (connection);
-		if (   s_con
-		    && (   !nm_setting_connection_get_master (s_con)
-		        || nm_connection_get_setting_wireless (connection)))
-			g_ptr_array_add (connections, g_object_ref (connection));
+		if (   !s_con
+		    || (   nm_setting_connection_get_master (s_con)
+		        && !nm_connection_get_setting_wireless (connection)))
+			continue;
+
+		g_ptr_array_add (applet->connections_all, g_object_ref (connection));
+
+		if (connection_is_vpn (connection)) {
+			g_ptr_array_add (applet->connections_vpn, g_object_ref (connection));
+			continue;
+		}
+
+		type = connection_get_device_type (connection);
+		if (type == NM_DEVICE_TYPE_UNKNOWN)
+			continue;
+
+		subset = g_hash_table_lookup (applet->connections_by_type, GUINT_TO_POINTER (type));
+		if (!subset) {
+			subset = g_ptr_array_new_with_free_func (g_object_unref);
+			g_hash_table_insert (applet->connections_by_type, GUINT_TO_POINTER (type), subset);
+		}
+		g_ptr_array_add (subset, g_object_ref (connection));
 	}
 
-	return connections;
+	g_ptr_array_sort (applet->connections_vpn, sort_vpn_connections);
 }
 
-static NMActiveConnection *
-applet_get_active_for_connection (NMApplet *applet, NMConnection *connection)
+/* Returns a reference to the applet's connection snapshot.  The array is
+ * shared and must not be modified; release it with g_ptr_array_unref().
+ */
+GPtrArray *
+applet_get_all_connections (NMApplet *applet)
+{
+	connections_snapshot_sync (applet);
+	return g_ptr_array_ref (applet->connections_all);
+}
+
+/* Like applet_get_all_connections(), but only returns the connections
+ * that devices of @type could possibly use.
+ */
+GPtrArray *
+applet_get_connections_for_device_type (NMApplet *applet, NMDeviceType type)
+{
+	GPtrArray *subset;
+
+	connections_snapshot_sync (applet);
+	subset = g_hash_table_lookup (applet->connections_by_type, GUINT_TO_POINTER (type));
+	if (!subset) {
+		subset = g_ptr_array_new_with_free_func (g_object_unref);
+		g_hash_table_insert (applet->connections_by_type, GUINT_TO_POINTER (type), subset);
+	}
+	return g_ptr_array_ref (subset);
+}
+
+static void
+active_index_clear (NMApplet *applet)
+{
+	g_clear_pointer (&applet->active_by_device, g_hash_table_unref);
+	g_clear_pointer (&applet->exported_by_device, g_hash_table_unref);
+	g_clear_pointer (&applet->active_by_connection, g_hash_table_unref);
+}
+
+/* Index the active connections by device and by connection path, keeping
+ * the first match in nm_client_get_active_connections() order.
+ */
+static void
+active_index_rebuild (NMApplet *applet)
 {
 	const GPtrArray *active_list;
-	int i;
-	const char *cpath;
+	int i, j;
 
-	cpath = nm_connection_get_path (connection);
-	g_return_val_if_fail (cpath != NULL, NULL);
+	active_index_clear (applet);
+
+	applet->active_by_device = g_hash_table_new_full (NULL, NULL, g_object_unref, g_object_unref);
+	applet->exported_by_device = g_hash_table_new_full (NULL, NULL, g_object_unref, g_object_unref);
+	applet->active_by_connection = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
 
 	active_list = nm_client_get_active_connections (applet->nm_client);
 	for (i = 0; active_list && (i < active_list->len); i++) {
 		NMActiveConnection *active = NM_ACTIVE_CONNECTION (g_ptr_array_index (active_list, i));
-		NMRemoteConnection *conn = nm_active_connection_get_connection (active);
+		NMRemoteConnection *connection;
+		const GPtrArray *devices;
+		const char *cpath;
 
-		if (conn) {
-			const char *active_cpath = nm_connection_get_path (NM_CONNECTION (conn));
+		connection = nm_active_connection_get_connection (active);
+		if (!connection)
+			continue;
+
+		cpath = nm_connection_get_path (NM_CONNECTION (connection));
+		if (cpath && !g_hash_table_contains (applet->active_by_connection, cpath)) {
+			g_hash_table_insert (applet->active_by_connection,
+			                     g_strdup (cpath), g_object_ref (active));
+		}
+
+		devices = nm_active_connection_get_devices (active);
+		for (j = 0; devices && (j < devices->len); j++) {
+			NMDevice *device = g_ptr_array_index (devices, j);
+
+			if (!g_hash_table_contains (applet->exported_by_device, device)) {
+				g_hash_table_insert (applet->exported_by_device,
+				                     g_object_ref (device), g_object_ref (active));
+			}
 
-			if (active_cpath && !strcmp (active_cpath, cpath))
-				return active;
+			/* Skip VPN connections */
+			if (   !nm_active_connection_get_vpn (active)
+			    && !g_hash_table_contains (applet->active_by_device, device)) {
+				g_hash_table_insert (applet->active_by_device,
+				                     g_object_ref (device), g_object_ref (active));
+			}
 		}
 	}
-	return NULL;
 }
 
-NMDevice *
-applet_get_device_for_connection (NMApplet *applet, NMConnection *connection)
+static void
+active_index_ensure (NMApplet *applet)
+{
+	if (!applet->active_by_device)
+		active_index_rebuild (applet);
+}
+
+static NMActiveConnection *
+applet_get_active_for_connection (NMApplet *applet, NMConnection *connection)
 {
-	const GPtrArray *active_list;
 	const char *cpath;
-	int i;
 
 	cpath = nm_connection_get_path (connection);
 	g_return_val_if_fail (cpath != NULL, NULL);
 
-	active_list = nm_client_get_active_connections (applet->nm_client);
-	for (i = 0; active_list && (i < active_list->len); i++) {
-		NMActiveConnection *active = NM_ACTIVE_CONNECTION (g_ptr_array_index (active_list, i));
-		NMRemoteConnection *ac_conn = nm_active_connection_get_connection (active);
+	active_index_ensure (applet);
+	return g_hash_table_lookup (applet->active_by_connection, cpath);
+}
 
-		if (!g_strcmp0 (nm_connection_get_path (NM_CONNECTION (ac_conn)), cpath))
-			return g_ptr_array_index (nm_active_connection_get_devices (active), 0);
-	}
-	return NULL;
+NMDevice *
+applet_get_device_for_connection (NMApplet *applet, NMConnection *connection)
+{
+	NMActiveConnection *active;
+	const GPtrArray *devices;
+
+	active = applet_get_active_for_connection (applet, connection);
+	if (!active)
+		return NULL;
+
+	devices = nm_active_connection_get_devices (active);
+	if (!devices || !devices->len)
+		return NULL;
+	return g_ptr_array_index (devices, 0);
 }
 
 typedef struct {
@@ -781,13 +931,6 @@ applet_is_any_device_activating (NMApplet *applet)
 	return FALSE;
 }
 
-static gboolean
-connection_is_vpn (NMConnection *connection)
-{
-	return    nm_connection_is_type (connection, NM_SETTING_VPN_SETTING_NAME)
-	       || nm_connection_is_type (connection, NM_SETTING_WIREGUARD_SETTING_NAME);
-}
-
 static gboolean
 applet_is_any_vpn_activating (NMApplet *applet)
 {
@@ -1145,57 +1288,26 @@ sort_devices_by_description (gconstpointer a, gconstpointer b)
 	return g_strcmp0 (aa_desc, bb_desc);
 }
 
-static gboolean
-nm_g_ptr_array_contains (const GPtrArray *haystack, gpointer needle)
-{
-	int i;
-
-	for (i = 0; haystack && (i < haystack->len); i++) {
-		if (g_ptr_array_index (haystack, i) == needle)
-			return TRUE;
-	}
-	return FALSE;
-}
-
 static NMConnection *
 applet_find_active_connection_for_device (NMDevice *device,
                                           NMApplet *applet,
                                           NMActiveConnection **out_active)
 {
-	const GPtrArray *active_connections;
-	int i;
+	NMActiveConnection *active;
 
 	g_return_val_if_fail (NM_IS_DEVICE (device), NULL);
 	g_return_val_if_fail (NM_IS_APPLET (applet), NULL);
 	if (out_active)
 		g_return_val_if_fail (*out_active == NULL, NULL);
 
-	active_connections = nm_client_get_active_connections (applet->nm_client);
-	for (i = 0; i < active_connections->len; i++) {
-		NMRemoteConnection *conn;
-		NMActiveConnection *active;
-		const GPtrArray *devices;
-
-		active = NM_ACTIVE_CONNECTION (g_ptr_array_index (active_connections, i));
-		devices = nm_active_connection_get_devices (active);
-		conn = nm_active_connection_get_connection (active);
-
-		/* Skip VPN connections */
-		if (nm_active_connection_get_vpn (active))
-			continue;
-
-		if (!devices || !conn)
-			continue;
-
-		if (!nm_g_ptr_array_contains (devices, device))
-			continue;
-
-		if (out_active)
-			*out_active = active;
-		return NM_CONNECTION (conn);
-	}
+	active_index_ensure (applet);
+	active = g_hash_table_lookup (applet->active_by_device, device);
+	if (!active)
+		return NULL;
 
-	return NULL;
+	if (out_active)
+		*out_active = active;
+	return NM_CONNECTION (nm_active_connection_get_connection (active));
 }
 
 gboolean
@@ -1299,26 +1411,76 @@ nma_menu_device_get_menu_item (NMDevice *device,
 	return item;
 }
 
-static int
-add_device_items (NMDeviceType type, const GPtrArray *all_devices,
-                  const GPtrArray *all_connections,
-                  GtkWidget *menu, NMApplet *applet)
+/* Devices the menu shows are kept in per-type buckets, sorted by
+ * description, as they come and go.
+ */
+static GPtrArray *
+device_bucket_get (NMApplet *applet, NMDeviceType type, gboolean create)
 {
-	GSList *devices = NULL, *iter;
-	int i, n_devices = 0;
+	GPtrArray *bucket;
 
-	for (i = 0; all_devices && (i < all_devices->len); i++) {
-		NMDevice *device = all_devices->pdata[i];
+	if (!applet->devices_by_type) {
+		if (!create)
+			return NULL;
+		applet->devices_by_type = g_hash_table_new_full (NULL, NULL, NULL,
+		                                                 (GDestroyNotify) g_ptr_array_unref);
+	}
 
-		if (nm_device_get_device_type (device) == type) {
-			n_devices++;
-			devices = g_slist_prepend (devices, device);
-		}
+	bucket = g_hash_table_lookup (applet->devices_by_type, GUINT_TO_POINTER (type));
+	if (!bucket && create) {
+		bucket = g_ptr_array_new_with_free_func (g_object_unref);
+		g_hash_table_insert (applet->devices_by_type, GUINT_TO_POINTER (type), bucket);
+	}
+	return bucket;
+}
+
+static void
+device_bucket_add (NMApplet *applet, NMDevice *device)
+{
+	GPtrArray *bucket;
+	guint i;
+
+	bucket = device_bucket_get (applet, nm_device_get_device_type (device), TRUE);
+	for (i = 0; i < bucket->len; i++) {
+		if (bucket->pdata[i] == device)
+			return;
 	}
-	devices = g_slist_sort (devices, sort_devices_by_description);
 
-	for (iter = devices; iter; iter = iter->next) {
-		NMDevice *device = iter->data;
+	for (i = 0; i < bucket->len; i++) {
+		if (sort_devices_by_description (device, bucket->pdata[i]) < 0)
+			break;
+	}
+	g_ptr_array_insert (bucket, i, g_object_ref (device));
+}
+
+static void
+device_bucket_remove (NMApplet *applet, NMDevice *device)
+{
+	GPtrArray *bucket;
+
+	bucket = device_bucket_get (applet, nm_device_get_device_type (device), FALSE);
+	if (bucket)
+		g_ptr_array_remove (bucket, device);
+}
+
+static int
+add_device_items (NMDeviceType type, GtkWidget *menu, NMApplet *applet)
+{
+	GPtrArray *devices;
+	GPtrArray *all_connections;
+	int i, n_devices;
+
+	devices = device_bucket_get (applet, type, FALSE);
+	if (!devices || !devices->len)
+		return 0;
+	n_devices = devices->len;
+
+	/* The menu items may outlive a device removal */
+	devices = g_ptr_array_ref (devices);
+
+	all_connections = applet_get_connections_for_device_type (applet, type);
+	for (i = 0; i < devices->len; i++) {
+		NMDevice *device = devices->pdata[i];
 		NMADeviceClass *dclass;
 		NMConnection *active;
 		GPtrArray *connections;
@@ -1339,67 +1501,31 @@ add_device_items (NMDeviceType type, const GPtrArray *all_devices,
 			gtk_menu_shell_append (GTK_MENU_SHELL (menu), gtk_separator_menu_item_new ());
 	}
 
-	g_slist_free (devices);
+	g_ptr_array_unref (all_connections);
+	g_ptr_array_unref (devices);
 	return n_devices;
 }
 
 static void
 nma_menu_add_devices (GtkWidget *menu, NMApplet *applet)
 {
-	const GPtrArray *all_devices;
-	GPtrArray *all_connections;
 	gint n_items;
 
-	all_connections = applet_get_all_connections (applet);
-	all_devices = nm_client_get_devices (applet->nm_client);
-
 	n_items = 0;
-	n_items += add_device_items  (NM_DEVICE_TYPE_ETHERNET,
-	                              all_devices, all_connections, menu, applet);
-	n_items += add_device_items  (NM_DEVICE_TYPE_WIFI,
-	                              all_devices, all_connections, menu, applet);
-	n_items += add_device_items  (NM_DEVICE_TYPE_MODEM,
-	                              all_devices, all_connections, menu, applet);
-	n_items += add_device_items  (NM_DEVICE_TYPE_BT,
-	                              all_devices, all_connections, menu, applet);
-
-	g_ptr_array_unref (all_connections);
+	n_items += add_device_items  (NM_DEVICE_TYPE_ETHERNET, menu, applet);
+	n_items += add_device_items  (NM_DEVICE_TYPE_WIFI, menu, applet);
+	n_items += add_device_items  (NM_DEVICE_TYPE_MODEM, menu, applet);
+	n_items += add_device_items  (NM_DEVICE_TYPE_BT, menu, applet);
 
 	if (!n_items)
 		nma_menu_add_text_item (menu, _("No network devices available"));
 }
 
-static int
-sort_vpn_connections (gconstpointer a, gconstpointer b)
-{
-	NMConnection **ca = (NMConnection **) a;
-	NMConnection **cb = (NMConnection **) b;
-
-	return strcmp (nm_connection_get_id (NM_CONNECTION (*ca)), nm_connection_get_id (NM_CONNECTION (*cb)));
-}
-
 static GPtrArray *
 get_vpn_connections (NMApplet *applet)
 {
-	GPtrArray *all_connections, *vpn_connections;
-	int i;
-
-	all_connections = applet_get_all_connections (applet);
-	vpn_connections = g_ptr_array_new_full (5, g_object_unref);
-
-	for (i = 0; i < all_connections->len; i++) {
-		NMConnection *connection = NM_CONNECTION (all_connections->pdata[i]);
-
-		if (!connection_is_vpn (connection))
-			continue;
-
-		g_ptr_array_add (vpn_connections, g_object_ref (connection));
-	}
-
-	g_ptr_array_unref (all_connections);
-
-	g_ptr_array_sort (vpn_connections, sort_vpn_connections);
-	return vpn_connections;
+	connections_snapshot_sync (applet);
+	return g_ptr_array_ref (applet->connections_vpn);
 }
 
 static void
@@ -2078,30 +2204,11 @@ foo_set_icon (NMApplet *applet, guint32 layer, GdkPixbuf *pixbuf, const char *ic
 NMRemoteConnection *
 applet_get_exported_connection_for_device (NMDevice *device, NMApplet *applet)
 {
-	const GPtrArray *active_connections;
-	int i;
-
-	active_connections = nm_client_get_active_connections (applet->nm_client);
-	for (i = 0; active_connections && (i < active_connections->len); i++) {
-		NMActiveConnection *active;
-		NMRemoteConnection *connection;
-		const GPtrArray *devices;
-
-		active = g_ptr_array_index (active_connections, i);
-		if (!active)
-			continue;
-
-		devices = nm_active_connection_get_devices (active);
-		connection = nm_active_connection_get_connection (active);
-		if (!devices || !connection)
-			continue;
-
-		if (!nm_g_ptr_array_contains (devices, device))
-			continue;
+	NMActiveConnection *active;
 
-		return connection;
-	}
-	return NULL;
+	active_index_ensure (applet);
+	active = g_hash_table_lookup (applet->exported_by_device, device);
+	return active ? nm_active_connection_get_connection (active) : NULL;
 }
 
 static void
@@ -2184,6 +2291,8 @@ foo_device_added_cb (NMClient *client, NMDevice *device, gpointer user_data)
 	NMApplet *applet = NM_APPLET (user_data);
 	NMADeviceClass *dclass;
 
+	device_bucket_add (applet, device);
+
 	dclass = get_device_class (device, applet);
 	if (dclass && dclass->device_added)
 		dclass->device_added (device, applet);
@@ -2222,6 +2331,8 @@ foo_client_state_changed_cb (NMClient *client, GParamSpec *pspec, gpointer user_
 static void
 foo_device_removed_cb (NMClient *client, NMDevice *device, NMApplet *applet)
 {
+	device_bucket_remove (applet, device);
+
 	applet_schedule_update_icon (applet);
 	applet_schedule_update_menu (applet);
 }
@@ -2266,6 +2377,8 @@ foo_active_connections_changed_cb (NMClient *client,
 	const GPtrArray *active_list;
 	int i;
 
+	active_index_rebuild (applet);
+
 	/* Track the state of new VPN connections */
 	active_list = nm_client_get_active_connections (client);
 	for (i = 0; active_list && (i < active_list->len); i++) {
@@ -2290,6 +2403,34 @@ foo_active_connections_changed_cb (NMClient *client,
 	applet_schedule_update_menu (applet);
 }
 
+static void
+foo_connection_changed_cb (NMConnection *connection, NMApplet *applet)
+{
+	applet->connections_gen++;
+}
+
+static void
+foo_connection_added_cb (NMClient *client,
+                         NMRemoteConnection *connection,
+                         NMApplet *applet)
+{
+	g_signal_connect (connection, NM_CONNECTION_CHANGED,
+	                  G_CALLBACK (foo_connection_changed_cb),
+	                  applet);
+	applet->connections_gen++;
+}
+
+static void
+foo_connection_removed_cb (NMClient *client,
+                           NMRemoteConnection *connection,
+                           NMApplet *applet)
+{
+	g_signal_handlers_disconnect_by_func (connection,
+	                                      G_CALLBACK (foo_connection_changed_cb),
+	                                      applet);
+	applet->connections_gen++;
+}
+
 static void
 foo_manager_permission_changed (NMClient *client,
                                 NMClientPermission permission,
@@ -3289,6 +3430,8 @@ applet_startup (GApplication *app, gpointer user_data)
 	NMApplet *applet = NM_APPLET (app);
 	gs_free_error GError *error = NULL;
 	NMClientPermission perm;
+	const GPtrArray *connections;
+	int i;
 
 	g_set_application_name (_("NetworkManager Applet"));
 	gtk_window_set_default_icon_name ("network-workgroup");
@@ -3327,15 +3470,27 @@ applet_startup (GApplication *app, gpointer user_data)
 	g_signal_connect (applet->nm_client, "device-added",
 	                  G_CALLBACK (foo_device_added_cb),
 	                  applet);
-	if (INDICATOR_ENABLED (applet)) {
-		g_signal_connect (applet->nm_client, "device-removed",
-		                  G_CALLBACK (foo_device_removed_cb),
-		                  applet);
-	}
+	g_signal_connect (applet->nm_client, "device-removed",
+	                  G_CALLBACK (foo_device_removed_cb),
+	                  applet);
 	g_signal_connect (applet->nm_client, "notify::manager-running",
 	                  G_CALLBACK (foo_manager_running_cb),
 	                  applet);
 
+	/* Track connection changes; see applet->connections_gen */
+	g_signal_connect (applet->nm_client, NM_CLIENT_CONNECTION_ADDED,
+	                  G_CALLBACK (foo_connection_added_cb),
+	                  applet);
+	g_signal_connect (applet->nm_client, NM_CLIENT_CONNECTION_REMOVED,
+	                  G_CALLBACK (foo_connection_removed_cb),
+	                  applet);
+	connections = nm_client_get_connections (applet->nm_client);
+	for (i = 0; connections && (i < connections->len); i++) {
+		g_signal_connect (connections->pdata[i], NM_CONNECTION_CHANGED,
+		                  G_CALLBACK (foo_connection_changed_cb),
+		                  applet);
+	}
+
 	g_signal_connect (applet->nm_client, "permission-changed",
 	                  G_CALLBACK (foo_manager_permission_changed),
 	                  applet);
@@ -3435,6 +3590,10 @@ static void finalize (GObject *object)
 	while (g_slist_length (applet->secrets_reqs))
 		applet_secrets_request_free ((SecretsRequest *) applet->secrets_reqs->data);
 
+	connections_snapshot_clear (applet);
+	active_index_clear (applet);
+	g_clear_pointer (&applet->devices_by_type, g_hash_table_unref);
+
 	g_clear_object (&applet->info_dialog_ui);
 	g_clear_object (&applet->gsettings);
 	g_clear_object (&applet->nm_client);
@@ -94,6 +94,19 @@ typedef struct {
 	NMADeviceClass *bt_class;
 
 	/* Data model elements */
+	guint           connections_gen;   /* bumped on connection add/remove/change */
+	guint           connections_snapshot_gen;
+	GPtrArray *     connections_all;
+	GPtrArray *     connections_vpn;
+	GHashTable *    connections_by_type;
+
+	/* Active connections by device and by connection path */
+	GHashTable *    active_by_device;
+	GHashTable *    exported_by_device;
+	GHashTable *    active_by_connection;
+
+	/* Devices by type, each sorted by description */
+	GHashTable *    devices_by_type;
 	guint           update_icon_id;
 	char *          tip;
 
@@ -230,6 +243,7 @@ void applet_schedule_update_menu (NMApplet *applet);
 NMClient *applet_get_settings (NMApplet *applet);
 
 GPtrArray *applet_get_all_connections (NMApplet *applet);
+GPtrArray *applet_get_connections_for_device_type (NMApplet *applet, NMDeviceType type);
 
 gboolean nma_menu_device_check_unusable (NMDevice *device);
 
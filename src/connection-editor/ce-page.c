@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include "ce-page.h"
+#include "ce-utils.h"
 
 G_DEFINE_ABSTRACT_TYPE (CEPage, ce_page, G_TYPE_OBJECT)
 
@@ -378,24 +379,130 @@ ce_page_interface_name_valid (const char *iface, const char *property_name, GErr
 	return TRUE;
 }
 
+/* The combo entries built by _get_device_list() are cached on the NMClient,
+ * keyed by the arguments, and shared by all pages.  The whole cache is
+ * dropped when a device comes or goes, or when a property shown in the
+ * entries changes.
+ */
+#define DEVICE_LIST_CACHE_TAG "ce-page-device-list-cache"
+
+typedef struct {
+	GType device_type;
+	gboolean set_ifname;
+	const char *mac_property; /* interned */
+} DeviceListKey;
+
+typedef struct {
+	GHashTable *lists;         /* DeviceListKey -> char ** */
+	GHashTable *mac_properties; /* interned names of the MAC properties in use */
+} DeviceListCache;
+
+static guint
+device_list_key_hash (gconstpointer ptr)
+{
+	const DeviceListKey *key = ptr;
+
+	return   g_direct_hash (GSIZE_TO_POINTER (key->device_type))
+	       ^ (key->set_ifname ? 0x9e3779b9u : 0)
+	       ^ g_direct_hash (key->mac_property);
+}
+
+static gboolean
+device_list_key_equal (gconstpointer a, gconstpointer b)
+{
+	const DeviceListKey *key_a = a, *key_b = b;
+
+	return    key_a->device_type == key_b->device_type
+	       && key_a->set_ifname == key_b->set_ifname
+	       && key_a->mac_property == key_b->mac_property;
+}
+
+static void
+device_list_key_free (gpointer ptr)
+{
+	g_slice_free (DeviceListKey, ptr);
+}
+
+static void
+device_list_cache_device_notify (NMDevice *device, GParamSpec *pspec, NMClient *client)
+{
+	DeviceListCache *cache;
+
+	cache = g_object_get_data (G_OBJECT (client), DEVICE_LIST_CACHE_TAG);
+	if (!cache || !g_hash_table_size (cache->lists))
+		return;
+
+	if (   nm_streq (pspec->name, NM_DEVICE_INTERFACE)
+	    || nm_streq (pspec->name, NM_DEVICE_BT_NAME)
+	    || g_hash_table_contains (cache->mac_properties, g_intern_string (pspec->name)))
+		g_hash_table_remove_all (cache->lists);
+}
+
+static void
+device_list_cache_device_added (NMClient *client, NMDevice *device, DeviceListCache *cache)
+{
+	g_signal_connect_object (device, "notify", G_CALLBACK (device_list_cache_device_notify), client, 0);
+	g_hash_table_remove_all (cache->lists);
+}
+
+static void
+device_list_cache_device_removed (NMClient *client, NMDevice *device, DeviceListCache *cache)
+{
+	g_signal_handlers_disconnect_by_func (device, device_list_cache_device_notify, client);
+	g_hash_table_remove_all (cache->lists);
+}
+
+/* Freed along with the client, whose handlers go away with it; the
+ * handlers on the devices are bound to the client's lifetime. */
+static void
+device_list_cache_free (DeviceListCache *cache)
+{
+	g_hash_table_unref (cache->lists);
+	g_hash_table_unref (cache->mac_properties);
+	g_slice_free (DeviceListCache, cache);
+}
+
+static DeviceListCache *
+device_list_cache_get (NMClient *client)
+{
+	DeviceListCache *cache;
+	const GPtrArray *devices;
+	guint i;
+
+	cache = g_object_get_data (G_OBJECT (client), DEVICE_LIST_CACHE_TAG);
+	if (cache)
+		return cache;
+
+	cache = g_slice_new (DeviceListCache);
+	cache->lists = g_hash_table_new_full (device_list_key_hash, device_list_key_equal,
+	                                      device_list_key_free, (GDestroyNotify) g_strfreev);
+	cache->mac_properties = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	g_signal_connect (client, NM_CLIENT_DEVICE_ADDED,
+	                  G_CALLBACK (device_list_cache_device_added), cache);
+	g_signal_connect (client, NM_CLIENT_DEVICE_REMOVED,
+	                  G_CALLBACK (device_list_cache_device_removed), cache);
+	devices = nm_client_get_devices (client);
+	for (i = 0; i < devices->len; i++)
+		g_signal_connect_object (devices->pdata[i], "notify", G_CALLBACK (device_list_cache_device_notify), client, 0);
+
+	g_object_set_data_full (G_OBJECT (client), DEVICE_LIST_CACHE_TAG, cache,
+	                        (GDestroyNotify) device_list_cache_free);
+	return cache;
+}
+
 static char **
-_get_device_list (CEPage *self,
-                  GType device_type,
-                  gboolean set_ifname,
-                  const char *mac_property)
+_build_device_list (NMClient *client,
+                    GType device_type,
+                    gboolean set_ifname,
+                    const char *mac_property)
 {
 	const GPtrArray *devices;
 	GPtrArray *interfaces;
 	int i;
 
-	g_return_val_if_fail (CE_IS_PAGE (self), NULL);
-	g_return_val_if_fail (set_ifname || mac_property, NULL);
-
-	if (!self->client)
-		return NULL;
-
 	interfaces = g_ptr_array_new ();
-	devices = nm_client_get_devices (self->client);
+	devices = nm_client_get_devices (client);
 	for (i = 0; i < devices->len; i++) {
 		NMDevice *dev = g_ptr_array_index (devices, i);
 		const char *ifname;
@@ -431,6 +538,44 @@ _get_device_list (CEPage *self,
 	return (char **)g_ptr_array_free (interfaces, FALSE);
 }
 
+/* Returns: (transfer none): the entries for a device combo, owned by the cache */
+static const char *const *
+_get_device_list (CEPage *self,
+                  GType device_type,
+                  gboolean set_ifname,
+                  const char *mac_property)
+{
+	DeviceListCache *cache;
+	DeviceListKey key, *new_key;
+	char **list;
+
+	g_return_val_if_fail (CE_IS_PAGE (self), NULL);
+	g_return_val_if_fail (set_ifname || mac_property, NULL);
+
+	if (!self->client)
+		return NULL;
+
+	cache = device_list_cache_get (self->client);
+
+	key.device_type = device_type;
+	key.set_ifname = set_ifname;
+	key.mac_property = mac_property ? g_intern_string (mac_property) : NULL;
+
+	list = g_hash_table_lookup (cache->lists, &key);
+	if (list)
+		return (const char *const *) list;
+
+	list = _build_device_list (self->client, device_type, set_ifname, mac_property);
+
+	new_key = g_slice_new (DeviceListKey);
+	*new_key = key;
+	g_hash_table_insert (cache->lists, new_key, list);
+	if (key.mac_property)
+		g_hash_table_add (cache->mac_properties, (gpointer) key.mac_property);
+
+	return (const char *const *) list;
+}
+
 static gboolean
 _device_entry_parse (const char *entry_text, char **first, char **second)
 {
@@ -505,9 +650,10 @@ ce_page_setup_device_combo (CEPage *self,
                             const char *mac,
                             const char *mac_property)
 {
-	char **iter, *active_item = NULL;
+	const char *const *iter;
+	const char *active_item = NULL;
+	const char *const *device_list;
 	int i, active_idx = -1;
-	char **device_list;
 	char *item;
 
 	device_list = _get_device_list (self, device_type, TRUE, mac_property);
@@ -529,7 +675,6 @@ ce_page_setup_device_combo (CEPage *self,
 	_set_active_combo_item (combo, item, active_item, active_idx);
 
 	g_free (item);
-	g_strfreev (device_list);
 }
 
 gboolean
@@ -601,45 +746,6 @@ invalid:
 	return FALSE;
 }
 
-char *
-ce_page_get_next_available_name (const GPtrArray *connections, const char *format)
-{
-	GSList *names = NULL, *iter;
-	char *cname = NULL;
-	int i = 0;
-
-	for (i = 0; i < connections->len; i++) {
-		const char *id;
-
-		id = nm_connection_get_id (connections->pdata[i]);
-		g_assert (id);
-		names = g_slist_append (names, (gpointer) id);
-	}
-
-	/* Find the next available unique connection name */
-	for (i = 1; !cname && i < 10000; i++) {
-		char *temp;
-		gboolean found = FALSE;
-
-		NM_PRAGMA_WARNING_DISABLE("-Wformat-nonliteral")
-		temp = g_strdup_printf (format, i);
-		NM_PRAGMA_WARNING_REENABLE
-		for (iter = names; iter; iter = g_slist_next (iter)) {
-			if (!strcmp (iter->data, temp)) {
-				found = TRUE;
-				break;
-			}
-		}
-		if (!found)
-			cname = temp;
-		else
-			g_free (temp);
-	}
-
-	g_slist_free (names);
-	return cname;
-}
-
 void
 ce_page_complete_init (CEPage *self,
                        const char *setting_name,
@@ -877,7 +983,7 @@ ce_page_complete_connection (NMConnection *connection,
 		gs_free char *id = NULL;
 
 		connections = nm_client_get_connections (client);
-		id = ce_page_get_next_available_name (connections, format);
+		id = utils_next_available_name (connections, format);
 		g_object_set (s_con, NM_SETTING_CONNECTION_ID, id, NULL);
 	}
 
@@ -152,8 +152,6 @@ void ce_page_complete_init (CEPage *self,
                             GVariant *secrets,
                             GError *error);
 
-char *ce_page_get_next_available_name (const GPtrArray *connections, const char *format);
-
 /* Only for subclasses */
 void ce_page_complete_connection (NMConnection *connection,
                                   const char *format,
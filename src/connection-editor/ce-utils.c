@@ -6,7 +6,12 @@
 
 #include "nm-default.h"
 
+#include <string.h>
+#include <arpa/inet.h>
+
 #include "ce-utils.h"
+#include "utils.h"
+#include "nm-utils/nm-shared-utils.h"
 
 /* Change key in @event to 'Enter' key. */
 void
@@ -23,3 +28,794 @@ utils_fake_return_key (GdkEventKey *event)
 	}
 	g_free (keys);
 }
+
+/* Caches the collate key of @id, so that sorting by name only needs a
+ * strcmp() per comparison. */
+void
+utils_sort_keys_set (UtilsSortKeys *keys, const char *id, guint64 timestamp)
+{
+	g_free (keys->collate_key);
+	keys->collate_key = g_utf8_collate_key (id ?: "", -1);
+	keys->timestamp = timestamp;
+}
+
+void
+utils_sort_keys_clear (UtilsSortKeys *keys)
+{
+	g_clear_pointer (&keys->collate_key, g_free);
+	keys->timestamp = 0;
+}
+
+int
+utils_sort_keys_cmp_id (const UtilsSortKeys *a, const UtilsSortKeys *b)
+{
+	return strcmp (a->collate_key, b->collate_key);
+}
+
+/* The most recently used connection first, the never used ones (0) last.
+ * The difference of the timestamps may not fit an int. */
+int
+utils_sort_keys_cmp_timestamp (const UtilsSortKeys *a, const UtilsSortKeys *b)
+{
+	if (a->timestamp == b->timestamp)
+		return 0;
+	return a->timestamp < b->timestamp ? 1 : -1;
+}
+
+/* Names are numbered from 1 up to this, exclusive */
+#define NEXT_NAME_MAX 10000
+
+/* If @format is "<prefix>%d<suffix>" without other conversions, returns the
+ * number that @id was formatted with, or 0 if it doesn't follow @format. */
+static guint
+_name_number (const char *id, const char *prefix, gsize prefix_len, const char *suffix, gsize suffix_len)
+{
+	gsize len = strlen (id);
+	const char *digits;
+	gsize n_digits, i;
+	guint number = 0;
+
+	if (   len <= prefix_len + suffix_len
+	    || strncmp (id, prefix, prefix_len) != 0
+	    || strcmp (id + len - suffix_len, suffix) != 0)
+		return 0;
+
+	digits = id + prefix_len;
+	n_digits = len - prefix_len - suffix_len;
+
+	/* Only the exact output of "%d" counts: no sign, no leading zeros */
+	if (n_digits > 4 || digits[0] == '0')
+		return 0;
+	for (i = 0; i < n_digits; i++) {
+		if (!g_ascii_isdigit (digits[i]))
+			return 0;
+		number = number * 10 + (digits[i] - '0');
+	}
+	return number;
+}
+
+/**
+ * utils_next_available_name:
+ * @connections: the existing #NMConnections
+ * @format: a name format with a "%d" for the number
+ *
+ * Returns: @format filled in with the lowest number from 1 on that gives
+ *   a name none of @connections has, or %NULL if all of them are taken.
+ */
+char *
+utils_next_available_name (const GPtrArray *connections, const char *format)
+{
+	const char *conv;
+	int i;
+
+	conv = strstr (format, "%d");
+	if (conv && !strchr (conv + 2, '%') && !memchr (format, '%', conv - format)) {
+		guint32 used[(NEXT_NAME_MAX + 31) / 32] = { 0 };
+		gs_free char *prefix = g_strndup (format, conv - format);
+		const char *suffix = conv + 2;
+		gsize prefix_len = conv - format;
+		gsize suffix_len = strlen (suffix);
+
+		/* One pass over the names to collect the numbers that are taken */
+		for (i = 0; i < connections->len; i++) {
+			const char *id;
+			guint number;
+
+			id = nm_connection_get_id (connections->pdata[i]);
+			g_assert (id);
+			number = _name_number (id, prefix, prefix_len, suffix, suffix_len);
+			if (number)
+				used[number / 32] |= 1u << (number % 32);
+		}
+
+		for (i = 1; i < NEXT_NAME_MAX; i++) {
+			if (!(used[i / 32] & (1u << (i % 32))))
+				return g_strdup_printf ("%s%d%s", prefix, i, suffix);
+		}
+	} else {
+		gs_unref_hashtable GHashTable *names = NULL;
+
+		/* A format we can't take apart, e.g. with reordered arguments
+		 * in a translation; check the candidates against a set. */
+		names = g_hash_table_new (g_str_hash, g_str_equal);
+		for (i = 0; i < connections->len; i++) {
+			const char *id;
+
+			id = nm_connection_get_id (connections->pdata[i]);
+			g_assert (id);
+			g_hash_table_add (names, (gpointer) id);
+		}
+
+		for (i = 1; i < NEXT_NAME_MAX; i++) {
+			char *temp;
+
+			NM_PRAGMA_WARNING_DISABLE("-Wformat-nonliteral")
+			temp = g_strdup_printf (format, i);
+			NM_PRAGMA_WARNING_REENABLE
+			if (!g_hash_table_contains (names, temp))
+				return temp;
+			g_free (temp);
+		}
+	}
+
+	return NULL;
+}
+
+/* Only this many parse errors are spelled out in the error report */
+#define MAX_REPORTED_ERRORS 20
+
+static const char *const route_valued_keywords[] = {
+	"dev", "proto", "scope", "src", "table", "mtu", "advmss", "weight",
+	"pref", "expires", "realm", "realms", "hoplimit", "initcwnd", "initrwnd",
+	"rto_min", "quickack", "congctl", "tos", "dsfield", "window", "rtt",
+	"rttvar", "ssthresh", "cwnd", "features", "fastopen_no_cookie", "nhid",
+	NULL
+};
+
+static const char *const route_flag_keywords[] = {
+	"onlink", "linkdown", "dead", "pervasive", "offload", "trap", "notify",
+	NULL
+};
+
+static gboolean
+is_keyword (const char *const *keywords, const char *str)
+{
+	for (; *keywords; keywords++) {
+		if (nm_streq (*keywords, str))
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static gboolean
+parse_route_address (int family, const char *str)
+{
+	union {
+		struct in_addr addr4;
+		struct in6_addr addr6;
+	} tmp_addr;
+
+	return inet_pton (family, str, &tmp_addr) > 0;
+}
+
+static gboolean
+parse_route_line (char *line,
+                  int family,
+                  UtilsRouteFunc func,
+                  gpointer user_data,
+                  GError **error)
+{
+	const char *dest = NULL;
+	const char *next_hop = NULL;
+	const char *tok;
+	char *saveptr = NULL;
+	char *slash;
+	gint64 prefix = -1;
+	gint64 metric = -1;
+	guint max_prefix = family == AF_INET ? 32 : 128;
+
+	tok = strtok_r (line, " \t", &saveptr);
+	if (nm_streq0 (tok, "unicast"))
+		tok = strtok_r (NULL, " \t", &saveptr);
+	if (!tok) {
+		g_set_error_literal (error, NMA_ERROR, NMA_ERROR_GENERIC, _("missing destination"));
+		return FALSE;
+	}
+	if (NM_IN_STRSET (tok, "blackhole", "unreachable", "prohibit", "throw", "local",
+	                       "broadcast", "anycast", "multicast", "nat")) {
+		g_set_error (error, NMA_ERROR, NMA_ERROR_GENERIC,
+		             _("unsupported route type “%s”"), tok);
+		return FALSE;
+	}
+
+	/* Destination */
+	if (nm_streq0 (tok, "default")) {
+		dest = family == AF_INET ? "0.0.0.0" : "::";
+		prefix = 0;
+	} else {
+		slash = strchr (tok, '/');
+		if (slash) {
+			*slash = '\0';
+			prefix = _nm_utils_ascii_str_to_int64 (slash + 1, 10, 0, max_prefix, -1);
+			if (prefix == -1) {
+				g_set_error (error, NMA_ERROR, NMA_ERROR_GENERIC,
+				             _("invalid prefix “%s”"), slash + 1);
+				return FALSE;
+			}
+		} else
+			prefix = max_prefix;
+		dest = tok;
+		if (!parse_route_address (family, dest)) {
+			g_set_error (error, NMA_ERROR, NMA_ERROR_GENERIC,
+			             _("invalid destination “%s”"), dest);
+			return FALSE;
+		}
+	}
+
+	/* Attributes */
+	while ((tok = strtok_r (NULL, " \t", &saveptr))) {
+		const char *value;
+
+		if (is_keyword (route_flag_keywords, tok))
+			continue;
+
+		value = strtok_r (NULL, " \t", &saveptr);
+		if (!value) {
+			g_set_error (error, NMA_ERROR, NMA_ERROR_GENERIC,
+			             _("missing value for “%s”"), tok);
+			return FALSE;
+		}
+
+		if (nm_streq (tok, "via")) {
+			/* "via inet6 ADDR" names the family explicitly */
+			if (NM_IN_STRSET (value, "inet", "inet6")) {
+				value = strtok_r (NULL, " \t", &saveptr);
+				if (!value) {
+					g_set_error (error, NMA_ERROR, NMA_ERROR_GENERIC,
+					             _("missing value for “%s”"), tok);
+					return FALSE;
+				}
+			}
+			if (!parse_route_address (family, value)) {
+				g_set_error (error, NMA_ERROR, NMA_ERROR_GENERIC,
+				             _("invalid gateway “%s”"), value);
+				return FALSE;
+			}
+			next_hop = value;
+		} else if (NM_IN_STRSET (tok, "metric", "preference", "priority")) {
+			metric = _nm_utils_ascii_str_to_int64 (value, 10, 0, G_MAXUINT32, -1);
+			if (metric == -1) {
+				g_set_error (error, NMA_ERROR, NMA_ERROR_GENERIC,
+				             _("invalid metric “%s”"), value);
+				return FALSE;
+			}
+		} else if (!is_keyword (route_valued_keywords, tok)) {
+			g_set_error (error, NMA_ERROR, NMA_ERROR_GENERIC,
+			             _("unknown attribute “%s”"), tok);
+			return FALSE;
+		}
+	}
+
+	return func (dest, prefix, next_hop, metric, user_data, error);
+}
+
+/**
+ * utils_parse_routes:
+ * @stream: text in the format of `ip route` output, one route per line
+ * @family: %AF_INET or %AF_INET6
+ * @func: called for each route that was parsed
+ * @user_data: data for @func
+ * @errors: (allow-none): a per-line description of lines that could not
+ *   be parsed is appended here
+ * @out_n_errors: (allow-none): number of lines that could not be parsed
+ * @error: location for an I/O error
+ *
+ * Reads the routes from @stream line by line.  Empty lines and comments
+ * are skipped; other lines that can't be parsed, or that @func rejects,
+ * are reported in @errors and don't stop the parsing.
+ *
+ * Returns: %FALSE if @stream could not be read.
+ */
+gboolean
+utils_parse_routes (GInputStream *stream,
+                    int family,
+                    UtilsRouteFunc func,
+                    gpointer user_data,
+                    GString *errors,
+                    guint *out_n_errors,
+                    GError **error)
+{
+	gs_unref_object GDataInputStream *data = NULL;
+	GError *local = NULL;
+	guint line_no = 0;
+	guint n_errors = 0;
+	char *line;
+
+	g_return_val_if_fail (family == AF_INET || family == AF_INET6, FALSE);
+
+	data = g_data_input_stream_new (stream);
+	g_data_input_stream_set_newline_type (data, G_DATA_STREAM_NEWLINE_TYPE_ANY);
+
+	while ((line = g_data_input_stream_read_line (data, NULL, NULL, &local))) {
+		char *hash;
+
+		line_no++;
+
+		hash = strchr (line, '#');
+		if (hash)
+			*hash = '\0';
+		g_strstrip (line);
+
+		if (line[0] && !parse_route_line (line, family, func, user_data, &local)) {
+			if (errors && n_errors < MAX_REPORTED_ERRORS)
+				g_string_append_printf (errors, _("Line %u: %s\n"), line_no, local->message);
+			g_clear_error (&local);
+			n_errors++;
+		}
+		g_free (line);
+	}
+
+	if (errors && n_errors > MAX_REPORTED_ERRORS) {
+		g_string_append_printf (errors,
+		                        ngettext ("…and %u more error\n", "…and %u more errors\n",
+		                                  n_errors - MAX_REPORTED_ERRORS),
+		                        n_errors - MAX_REPORTED_ERRORS);
+	}
+
+	NM_SET_OUT (out_n_errors, n_errors);
+
+	if (local) {
+		g_propagate_error (error, local);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+typedef struct {
+	GPtrArray *peers;
+
+	/* The [Peer] section being parsed */
+	NMWireGuardPeer *peer;
+	guint peer_line;
+	gboolean peer_invalid;
+
+	GString *errors;
+	guint n_errors;
+} ImportPeersData;
+
+static void
+import_peers_error (ImportPeersData *data, guint line_no, const char *message)
+{
+	if (data->errors && data->n_errors < MAX_REPORTED_ERRORS)
+		g_string_append_printf (data->errors, _("Line %u: %s\n"), line_no, message);
+	data->n_errors++;
+}
+
+static void
+import_peers_finish_peer (ImportPeersData *data)
+{
+	gs_free_error GError *error = NULL;
+
+	if (!data->peer)
+		return;
+
+	if (!data->peer_invalid) {
+		/* The key was in the file in plain text; keep it with the
+		 * connection, like the peer dialog does unless told otherwise. */
+		if (nm_wireguard_peer_get_preshared_key (data->peer))
+			nm_wireguard_peer_set_preshared_key_flags (data->peer, NM_SETTING_SECRET_FLAG_NONE);
+
+		if (nm_wireguard_peer_is_valid (data->peer, TRUE, TRUE, &error)) {
+			nm_wireguard_peer_seal (data->peer);
+			g_ptr_array_add (data->peers, g_steal_pointer (&data->peer));
+			return;
+		}
+		import_peers_error (data, data->peer_line, error->message);
+	}
+
+	g_clear_pointer (&data->peer, nm_wireguard_peer_unref);
+}
+
+static void
+import_peers_line (ImportPeersData *data, char *line, guint line_no)
+{
+	const char *key, *value;
+	gs_free char *message = NULL;
+	gboolean valid = TRUE;
+	char *eq;
+
+	if (line[0] == '[') {
+		import_peers_finish_peer (data);
+		if (g_ascii_strcasecmp (line, "[Peer]") == 0) {
+			data->peer = nm_wireguard_peer_new ();
+			data->peer_line = line_no;
+			data->peer_invalid = FALSE;
+		}
+		return;
+	}
+
+	/* Keys outside of [Peer] sections, such as [Interface], are ignored */
+	if (!data->peer)
+		return;
+
+	eq = strchr (line, '=');
+	if (!eq) {
+		import_peers_error (data, line_no, _("expected “key = value”"));
+		data->peer_invalid = TRUE;
+		return;
+	}
+	*eq = '\0';
+	key = g_strstrip (line);
+	value = g_strstrip (eq + 1);
+
+	if (g_ascii_strcasecmp (key, "PublicKey") == 0)
+		valid = nm_wireguard_peer_set_public_key (data->peer, value, FALSE);
+	else if (g_ascii_strcasecmp (key, "PresharedKey") == 0)
+		valid = nm_wireguard_peer_set_preshared_key (data->peer, value, FALSE);
+	else if (g_ascii_strcasecmp (key, "Endpoint") == 0)
+		valid = nm_wireguard_peer_set_endpoint (data->peer, value, FALSE);
+	else if (g_ascii_strcasecmp (key, "AllowedIPs") == 0) {
+		gs_strfreev char **strv = g_strsplit (value, ",", -1);
+		guint i;
+
+		for (i = 0; strv[i]; i++) {
+			g_strstrip (strv[i]);
+			if (strv[i][0] && !nm_wireguard_peer_append_allowed_ip (data->peer, strv[i], FALSE))
+				valid = FALSE;
+		}
+	} else if (g_ascii_strcasecmp (key, "PersistentKeepalive") == 0) {
+		gint64 keepalive = 0;
+
+		if (g_ascii_strcasecmp (value, "off") != 0)
+			keepalive = _nm_utils_ascii_str_to_int64 (value, 10, 0, G_MAXUINT16, -1);
+		if (keepalive == -1)
+			valid = FALSE;
+		else
+			nm_wireguard_peer_set_persistent_keepalive (data->peer, keepalive);
+	} else {
+		message = g_strdup_printf (_("unknown key “%s”"), key);
+		import_peers_error (data, line_no, message);
+		data->peer_invalid = TRUE;
+		return;
+	}
+
+	if (!valid) {
+		/* Don't echo the value, it may be a key */
+		message = g_strdup_printf (_("invalid value for “%s”"), key);
+		import_peers_error (data, line_no, message);
+		data->peer_invalid = TRUE;
+	}
+}
+
+/**
+ * utils_parse_wireguard_peers:
+ * @stream: a WireGuard configuration in wg-quick or `wg showconf` format
+ * @errors: (allow-none): a per-line description of the problems is
+ *   appended here
+ * @out_n_errors: (allow-none): number of problems found
+ * @error: location for an I/O error
+ *
+ * Reads the [Peer] sections of @stream; the other sections are ignored.
+ * A peer with an invalid or unknown key is reported in @errors and
+ * skipped, without stopping the parsing.
+ *
+ * Returns: (transfer full): the sealed peers that were read, also when
+ *   @error is set.
+ */
+GPtrArray *
+utils_parse_wireguard_peers (GInputStream *stream,
+                             GString *errors,
+                             guint *out_n_errors,
+                             GError **error)
+{
+	gs_unref_object GDataInputStream *data_stream = NULL;
+	ImportPeersData data = { 0 };
+	GError *local = NULL;
+	guint line_no = 0;
+	char *line;
+
+	data.peers = g_ptr_array_new_with_free_func ((GDestroyNotify) nm_wireguard_peer_unref);
+	data.errors = errors;
+
+	data_stream = g_data_input_stream_new (stream);
+	g_data_input_stream_set_newline_type (data_stream, G_DATA_STREAM_NEWLINE_TYPE_ANY);
+
+	while ((line = g_data_input_stream_read_line (data_stream, NULL, NULL, &local))) {
+		char *hash;
+
+		line_no++;
+
+		hash = strchr (line, '#');
+		if (hash)
+			*hash = '\0';
+		g_strstrip (line);
+
+		if (line[0])
+			import_peers_line (&data, line, line_no);
+		g_free (line);
+	}
+	import_peers_finish_peer (&data);
+
+	if (errors && data.n_errors > MAX_REPORTED_ERRORS) {
+		g_string_append_printf (errors,
+		                        ngettext ("…and %u more error\n", "…and %u more errors\n",
+		                                  data.n_errors - MAX_REPORTED_ERRORS),
+		                        data.n_errors - MAX_REPORTED_ERRORS);
+	}
+
+	NM_SET_OUT (out_n_errors, data.n_errors);
+
+	if (local)
+		g_propagate_error (error, local);
+	return data.peers;
+}
+
+/**
+ * utils_route_cells_check:
+ * @family: %AF_INET or %AF_INET6
+ * @cells: the destination, prefix, next hop and metric of a route as typed
+ *   in the routes dialogs, indexed by #UtilsRouteCell
+ * @out_dest: (allow-none): the destination
+ * @out_prefix: (allow-none): the prefix length
+ * @out_next_hop: (allow-none): the next hop, or %NULL if there's none
+ * @out_metric: (allow-none): the metric, or -1 if unset
+ *
+ * Both the dialogs' row validation and utils_routes_from_model_async()
+ * go through this, so that they agree on which rows are valid.  The out
+ * values are only meaningful when all cells are valid; the strings point
+ * into @cells.
+ *
+ * Returns: a mask with bit (1 << cell) set for each invalid cell.
+ */
+guint
+utils_route_cells_check (int family,
+                         const char *const *cells,
+                         const char **out_dest,
+                         guint32 *out_prefix,
+                         const char **out_next_hop,
+                         gint64 *out_metric)
+{
+	const char *dest = NULL, *next_hop = NULL;
+	guint32 prefix = 0;
+	gint64 prefix6 = 0, metric = -1;
+	guint invalid = 0;
+
+	g_return_val_if_fail (family == AF_INET || family == AF_INET6, 0);
+
+	if (!utils_str_get_address (cells[UTILS_ROUTE_CELL_DEST], family, TRUE, &dest))
+		invalid |= 1 << UTILS_ROUTE_CELL_DEST;
+
+	if (family == AF_INET) {
+		/* Don't allow zero prefix for now - that's not supported in libnm-util */
+		if (   !utils_str_get_ip4_prefix (cells[UTILS_ROUTE_CELL_PREFIX], TRUE, &prefix)
+		    || prefix == 0)
+			invalid |= 1 << UTILS_ROUTE_CELL_PREFIX;
+	} else {
+		if (utils_str_get_int64 (cells[UTILS_ROUTE_CELL_PREFIX], 1, 128, TRUE, &prefix6))
+			prefix = prefix6;
+		else
+			invalid |= 1 << UTILS_ROUTE_CELL_PREFIX;
+	}
+
+	/* Next hop (optional) */
+	if (!utils_str_get_address (cells[UTILS_ROUTE_CELL_NEXT_HOP], family, FALSE, &next_hop))
+		invalid |= 1 << UTILS_ROUTE_CELL_NEXT_HOP;
+
+	/* Metric (optional) */
+	if (!utils_str_get_int64 (cells[UTILS_ROUTE_CELL_METRIC], 0, G_MAXUINT32, FALSE, &metric))
+		invalid |= 1 << UTILS_ROUTE_CELL_METRIC;
+
+	NM_SET_OUT (out_dest, dest);
+	NM_SET_OUT (out_prefix, prefix);
+	NM_SET_OUT (out_next_hop, next_hop);
+	NM_SET_OUT (out_metric, metric);
+	return invalid;
+}
+
+/* Number of rows converted between cancellation checks and progress reports */
+#define ROUTES_CHUNK_SIZE 256
+
+typedef struct {
+	int family;
+	guint n_rows;
+	char **cells;
+	UtilsRoutesProgressFunc progress;
+	gpointer progress_data;
+	guint n_invalid;
+} RoutesFromModelData;
+
+typedef struct {
+	GTask *task;
+	guint done;
+} RoutesProgress;
+
+static void
+routes_from_model_data_free (RoutesFromModelData *data)
+{
+	guint i;
+
+	for (i = 0; i < data->n_rows * UTILS_ROUTE_N_CELLS; i++)
+		g_free (data->cells[i]);
+	g_free (data->cells);
+	g_slice_free (RoutesFromModelData, data);
+}
+
+static gboolean
+routes_progress_cb (gpointer user_data)
+{
+	RoutesProgress *progress = user_data;
+	RoutesFromModelData *data = g_task_get_task_data (progress->task);
+
+	if (!g_cancellable_is_cancelled (g_task_get_cancellable (progress->task)))
+		data->progress (progress->done, data->n_rows, data->progress_data);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+routes_progress_free (gpointer user_data)
+{
+	RoutesProgress *progress = user_data;
+
+	g_object_unref (progress->task);
+	g_slice_free (RoutesProgress, progress);
+}
+
+static void
+routes_progress_post (GTask *task, guint done)
+{
+	RoutesProgress *progress;
+
+	progress = g_slice_new (RoutesProgress);
+	progress->task = g_object_ref (task);
+	progress->done = done;
+	g_main_context_invoke_full (g_task_get_context (task), G_PRIORITY_DEFAULT,
+	                            routes_progress_cb, progress, routes_progress_free);
+}
+
+static void
+routes_from_model_thread (GTask *task,
+                          gpointer source_object,
+                          gpointer task_data,
+                          GCancellable *cancellable)
+{
+	RoutesFromModelData *data = task_data;
+	gs_unref_hashtable GHashTable *seen = NULL;
+	GPtrArray *routes;
+	guint i;
+
+	routes = g_ptr_array_new_full (data->n_rows, (GDestroyNotify) nm_ip_route_unref);
+	seen = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+	for (i = 0; i < data->n_rows; i++) {
+		char **cells = &data->cells[i * UTILS_ROUTE_N_CELLS];
+		const char *dest, *next_hop;
+		guint32 prefix;
+		gint64 metric;
+		NMIPRoute *route;
+		GError *local = NULL;
+		char *key;
+
+		if (i > 0 && i % ROUTES_CHUNK_SIZE == 0) {
+			if (g_task_return_error_if_cancelled (task)) {
+				g_ptr_array_unref (routes);
+				return;
+			}
+			if (data->progress)
+				routes_progress_post (task, i);
+		}
+
+		if (utils_route_cells_check (data->family, (const char *const *) cells,
+		                             &dest, &prefix, &next_hop, &metric)) {
+			data->n_invalid++;
+			continue;
+		}
+
+		route = nm_ip_route_new (data->family, dest, prefix, next_hop, metric, &local);
+		if (!route) {
+			g_debug ("%s: route %u rejected: %s", __func__, i, local->message);
+			g_clear_error (&local);
+			data->n_invalid++;
+			continue;
+		}
+
+		/* nm_setting_ip_config_add_route() drops duplicates with a linear
+		 * scan; do the same here with a hash so that the whole list can be
+		 * handed to the setting at once. */
+		key = g_strdup_printf ("%s/%u %s %" G_GINT64_FORMAT,
+		                       nm_ip_route_get_dest (route),
+		                       nm_ip_route_get_prefix (route),
+		                       nm_ip_route_get_next_hop (route) ?: "",
+		                       nm_ip_route_get_metric (route));
+		if (!g_hash_table_add (seen, key)) {
+			nm_ip_route_unref (route);
+			continue;
+		}
+
+		g_ptr_array_add (routes, route);
+	}
+
+	g_task_return_pointer (task, routes, (GDestroyNotify) g_ptr_array_unref);
+}
+
+/**
+ * utils_routes_from_model_async:
+ * @model: a model whose first four columns hold the destination, prefix,
+ *   next hop and metric of a route as strings, one route per row
+ * @family: %AF_INET or %AF_INET6
+ * @cancellable: (allow-none): a #GCancellable
+ * @progress: (allow-none): called on the calling thread's main context as
+ *   the conversion progresses
+ * @callback: called when the routes are ready
+ * @user_data: data for @progress and @callback
+ *
+ * Converts the rows of @model into #NMIPRoute objects in a worker thread.
+ * Only the strings are copied out of @model here, so it can be changed or
+ * destroyed while the conversion runs.  Rows that don't make a valid
+ * route are skipped and counted, duplicate routes are dropped.
+ */
+void
+utils_routes_from_model_async (GtkTreeModel *model,
+                               int family,
+                               GCancellable *cancellable,
+                               UtilsRoutesProgressFunc progress,
+                               GAsyncReadyCallback callback,
+                               gpointer user_data)
+{
+	gs_unref_object GTask *task = NULL;
+	RoutesFromModelData *data;
+	GtkTreeIter iter;
+	gboolean iter_valid;
+	guint i = 0;
+
+	g_return_if_fail (GTK_IS_TREE_MODEL (model));
+	g_return_if_fail (family == AF_INET || family == AF_INET6);
+
+	data = g_slice_new0 (RoutesFromModelData);
+	data->family = family;
+	data->n_rows = gtk_tree_model_iter_n_children (model, NULL);
+	data->cells = g_new0 (char *, data->n_rows * UTILS_ROUTE_N_CELLS);
+	data->progress = progress;
+	data->progress_data = user_data;
+
+	iter_valid = gtk_tree_model_get_iter_first (model, &iter);
+	while (iter_valid && i < data->n_rows) {
+		char **cells = &data->cells[i * UTILS_ROUTE_N_CELLS];
+
+		gtk_tree_model_get (model, &iter,
+		                    0, &cells[UTILS_ROUTE_CELL_DEST],
+		                    1, &cells[UTILS_ROUTE_CELL_PREFIX],
+		                    2, &cells[UTILS_ROUTE_CELL_NEXT_HOP],
+		                    3, &cells[UTILS_ROUTE_CELL_METRIC],
+		                    -1);
+		i++;
+		iter_valid = gtk_tree_model_iter_next (model, &iter);
+	}
+
+	task = g_task_new (NULL, cancellable, callback, user_data);
+	g_task_set_source_tag (task, utils_routes_from_model_async);
+	g_task_set_task_data (task, data, (GDestroyNotify) routes_from_model_data_free);
+	g_task_run_in_thread (task, routes_from_model_thread);
+}
+
+/**
+ * utils_routes_from_model_finish:
+ * @result: the #GAsyncResult passed to the callback
+ * @out_n_invalid: (allow-none): number of rows that were skipped
+ * @error: location for a #GError
+ *
+ * Returns: (transfer full): the #NMIPRoute objects, or %NULL if the
+ *   conversion was cancelled.
+ */
+GPtrArray *
+utils_routes_from_model_finish (GAsyncResult *result,
+                                guint *out_n_invalid,
+                                GError **error)
+{
+	RoutesFromModelData *data;
+
+	g_return_val_if_fail (g_task_is_valid (result, NULL), NULL);
+
+	data = g_task_get_task_data (G_TASK (result));
+	NM_SET_OUT (out_n_invalid, data->n_invalid);
+	return g_task_propagate_pointer (G_TASK (result), error);
+}
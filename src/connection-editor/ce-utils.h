@@ -11,4 +11,69 @@
 
 void utils_fake_return_key (GdkEventKey *event);
 
+/* The keys the connection list sorts its connection rows by */
+typedef struct {
+	char *collate_key;
+	guint64 timestamp;
+} UtilsSortKeys;
+
+void utils_sort_keys_set (UtilsSortKeys *keys, const char *id, guint64 timestamp);
+void utils_sort_keys_clear (UtilsSortKeys *keys);
+
+int utils_sort_keys_cmp_id (const UtilsSortKeys *a, const UtilsSortKeys *b);
+int utils_sort_keys_cmp_timestamp (const UtilsSortKeys *a, const UtilsSortKeys *b);
+
+char *utils_next_available_name (const GPtrArray *connections, const char *format);
+
+typedef gboolean (*UtilsRouteFunc) (const char *dest,
+                                    guint prefix,
+                                    const char *next_hop, /* allow-none */
+                                    gint64 metric,        /* -1 if unset */
+                                    gpointer user_data,
+                                    GError **error);
+
+gboolean utils_parse_routes (GInputStream *stream,
+                             int family,
+                             UtilsRouteFunc func,
+                             gpointer user_data,
+                             GString *errors,
+                             guint *out_n_errors,
+                             GError **error);
+
+GPtrArray *utils_parse_wireguard_peers (GInputStream *stream,
+                                       GString *errors,
+                                       guint *out_n_errors,
+                                       GError **error);
+
+/* The cells of a route row, in the column order of the routes dialogs */
+typedef enum {
+	UTILS_ROUTE_CELL_DEST,
+	UTILS_ROUTE_CELL_PREFIX,
+	UTILS_ROUTE_CELL_NEXT_HOP,
+	UTILS_ROUTE_CELL_METRIC,
+	UTILS_ROUTE_N_CELLS,
+} UtilsRouteCell;
+
+guint utils_route_cells_check (int family,
+                               const char *const *cells,
+                               const char **out_dest,
+                               guint32 *out_prefix,
+                               const char **out_next_hop,
+                               gint64 *out_metric);
+
+typedef void (*UtilsRoutesProgressFunc) (guint done,
+                                         guint total,
+                                         gpointer user_data);
+
+void utils_routes_from_model_async (GtkTreeModel *model,
+                                    int family,
+                                    GCancellable *cancellable,
+                                    UtilsRoutesProgressFunc progress,
+                                    GAsyncReadyCallback callback,
+                                    gpointer user_data);
+
+GPtrArray *utils_routes_from_model_finish (GAsyncResult *result,
+                                           guint *out_n_invalid,
+                                           GError **error);
+
 #endif /* __CE_UTILS_H__ */
@@ -162,6 +162,168 @@ no_description:
 	gtk_label_set_text (label, "");
 }
 
+/* Hints about the files a VPN plugin imports, matched against the plugin
+ * name.  They only decide the order in which plugins are tried. */
+static const struct {
+	const char *plugin_name;
+	const char *extensions[3];
+	const char *magic[5];
+} vpn_import_hints[] = {
+	{ "openvpn", { ".ovpn", ".conf" }, { "\nclient", "\nremote ", "\ndev tun", "\ndev tap", "<ca>" } },
+	{ "vpnc",    { ".pcf" },           { "[main]" } },
+};
+
+#define SNIFF_SIZE 4096
+
+typedef struct {
+	char *ext;
+	char *head;
+} ImportSniff;
+
+static void
+import_sniff_init (ImportSniff *sniff, const char *filename)
+{
+	char buf[SNIFF_SIZE + 1];
+	const char *dot;
+	size_t len = 0;
+	FILE *f;
+
+	dot = strrchr (filename, '.');
+	sniff->ext = dot && !strchr (dot, '/') ? g_ascii_strdown (dot, -1) : NULL;
+
+	/* Prefix a newline so that the magic can also match on the first line */
+	buf[0] = '\n';
+	f = fopen (filename, "re");
+	if (f) {
+		len = fread (&buf[1], 1, SNIFF_SIZE - 1, f);
+		fclose (f);
+	}
+	buf[len + 1] = '\0';
+	sniff->head = g_ascii_strdown (buf, len + 1);
+}
+
+static void
+import_sniff_clear (ImportSniff *sniff)
+{
+	g_clear_pointer (&sniff->ext, g_free);
+	g_clear_pointer (&sniff->head, g_free);
+}
+
+#if NM_CHECK_VERSION(1, 40, 0)
+static gboolean
+import_sniff_is_wireguard (const ImportSniff *sniff)
+{
+	return    nm_streq0 (sniff->ext, ".conf")
+	       && strstr (sniff->head, "\n[interface]")
+	       && strstr (sniff->head, "\n[peer]");
+}
+#endif
+
+static int
+import_sniff_score (const ImportSniff *sniff, NMVpnPluginInfo *plugin_info)
+{
+	const char *name = nm_vpn_plugin_info_get_name (plugin_info);
+	int score = 0;
+	guint i, j;
+
+	for (i = 0; i < G_N_ELEMENTS (vpn_import_hints); i++) {
+		if (!name || !strstr (name, vpn_import_hints[i].plugin_name))
+			continue;
+		for (j = 0; j < G_N_ELEMENTS (vpn_import_hints[i].extensions); j++) {
+			if (   vpn_import_hints[i].extensions[j]
+			    && nm_streq0 (sniff->ext, vpn_import_hints[i].extensions[j])) {
+				score += 1;
+				break;
+			}
+		}
+		for (j = 0; j < G_N_ELEMENTS (vpn_import_hints[i].magic); j++) {
+			if (   vpn_import_hints[i].magic[j]
+			    && strstr (sniff->head, vpn_import_hints[i].magic[j])) {
+				score += 2;
+				break;
+			}
+		}
+	}
+
+	return score;
+}
+
+typedef struct {
+	NMVpnPluginInfo *plugin_info;
+	int score;
+	guint idx;
+} RankedPlugin;
+
+static int
+ranked_plugin_cmp (gconstpointer a, gconstpointer b)
+{
+	const RankedPlugin *ra = a;
+	const RankedPlugin *rb = b;
+
+	if (ra->score != rb->score)
+		return rb->score - ra->score;
+	return ra->idx - rb->idx;
+}
+
+/* Returns the VPN plugins ordered by how likely they are to import the file,
+ * keeping the alphabetical order among equally likely ones. */
+static GArray *
+rank_vpn_plugins (GSList *plugin_infos, const ImportSniff *sniff)
+{
+	GArray *ranked;
+	RankedPlugin r;
+	GSList *iter;
+
+	ranked = g_array_new (FALSE, FALSE, sizeof (RankedPlugin));
+	for (iter = plugin_infos; iter; iter = iter->next) {
+		r.plugin_info = iter->data;
+		r.score = import_sniff_score (sniff, r.plugin_info);
+		r.idx = ranked->len;
+		g_array_append_val (ranked, r);
+	}
+	g_array_sort (ranked, ranked_plugin_cmp);
+	return ranked;
+}
+
+/* The VPN editor plugins make no promise about being thread-safe, and
+ * connection_import_one() runs on worker threads for --import-dir.  Each
+ * plugin gets its own lock, so that different plugins can run in parallel. */
+#define VPN_IMPORT_LOCK_TAG "nm-ce-vpn-import-lock"
+
+static GMutex vpn_import_locks_mutex;
+
+static void
+vpn_import_lock_free (gpointer data)
+{
+	GMutex *lock = data;
+
+	g_mutex_clear (lock);
+	g_slice_free (GMutex, lock);
+}
+
+static NMConnection *
+vpn_import (NMVpnEditorPlugin *plugin, const char *filename, GError **error)
+{
+	NMConnection *connection;
+	GMutex *lock;
+
+	g_mutex_lock (&vpn_import_locks_mutex);
+	lock = g_object_get_data (G_OBJECT (plugin), VPN_IMPORT_LOCK_TAG);
+	if (!lock) {
+		lock = g_slice_new (GMutex);
+		g_mutex_init (lock);
+		g_object_set_data_full (G_OBJECT (plugin), VPN_IMPORT_LOCK_TAG,
+		                        lock, vpn_import_lock_free);
+	}
+	g_mutex_unlock (&vpn_import_locks_mutex);
+
+	g_mutex_lock (lock);
+	connection = nm_vpn_editor_plugin_import (plugin, filename, error);
+	g_mutex_unlock (lock);
+
+	return connection;
+}
+
 NMConnection *
 connection_import_from_file (const char *filename,
                              GType ctype,
@@ -169,8 +331,11 @@ connection_import_from_file (const char *filename,
                              GError **error)
 {
 	gs_free_error GError *unused_error = NULL;
+	gs_free_error GError *wireguard_error = NULL;
 	NMConnection *connection = NULL;
-	GSList *iter;
+	ImportSniff sniff;
+	gboolean wireguard_first = FALSE;
+	guint i;
 
 	if (!error) {
 		/* Some VPN plugins crash when passing no error variable ([1]). Work
@@ -183,7 +348,20 @@ connection_import_from_file (const char *filename,
 		error = &unused_error;
 	}
 
-	if (NM_IN_SET (ctype, G_TYPE_INVALID, NM_TYPE_SETTING_VPN)) {
+	import_sniff_init (&sniff, filename);
+
+#if NM_CHECK_VERSION(1, 40, 0)
+	if (   ctype == G_TYPE_INVALID
+	    && !vpn_detail
+	    && import_sniff_is_wireguard (&sniff)) {
+		G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+		connection = nm_conn_wireguard_import (filename, &wireguard_error);
+		G_GNUC_END_IGNORE_DEPRECATIONS
+		wireguard_first = TRUE;
+	}
+#endif
+
+	if (!connection && NM_IN_SET (ctype, G_TYPE_INVALID, NM_TYPE_SETTING_VPN)) {
 		GSList *plugin_infos = vpn_get_plugin_infos ();
 		NMVpnPluginInfo *plugin_info;
 		NMVpnEditorPlugin *plugin;
@@ -195,18 +373,29 @@ connection_import_from_file (const char *filename,
 			         nm_vpn_plugin_info_list_find_service_type (plugin_infos, vpn_detail)) &&
 			    (plugin_info =
 			         nm_vpn_plugin_info_list_find_by_service (plugin_infos, service_type))) {
-				plugin = nm_vpn_plugin_info_get_editor_plugin (plugin_info);
-				connection = nm_vpn_editor_plugin_import (plugin, filename, error);
+				plugin = vpn_get_editor_plugin (plugin_info);
+				if (plugin)
+					connection = vpn_import (plugin, filename, error);
+				else {
+					g_set_error (error, NMA_ERROR, NMA_ERROR_GENERIC,
+					             _("VPN plugin “%s” could not be loaded"), vpn_detail);
+				}
 			} else {
 				g_set_error (error, NMA_ERROR, NMA_ERROR_GENERIC,
 				             _("VPN plugin “%s” not found"), vpn_detail);
 			}
 		} else {
-			for (iter = plugin_infos; iter; iter = iter->next) {
-				plugin_info = iter->data;
-				plugin = nm_vpn_plugin_info_get_editor_plugin (plugin_info);
+			gs_unref_array GArray *ranked = rank_vpn_plugins (plugin_infos, &sniff);
+
+			for (i = 0; i < ranked->len; i++) {
+				plugin_info = g_array_index (ranked, RankedPlugin, i).plugin_info;
+				plugin = vpn_get_editor_plugin (plugin_info);
+				if (!plugin)
+					continue;
+				if (!(nm_vpn_editor_plugin_get_capabilities (plugin) & NM_VPN_EDITOR_PLUGIN_CAPABILITY_IMPORT))
+					continue;
 				g_clear_error (error);
-				connection = nm_vpn_editor_plugin_import (plugin, filename, error);
+				connection = vpn_import (plugin, filename, error);
 				if (connection)
 					break;
 			}
@@ -229,7 +418,9 @@ connection_import_from_file (const char *filename,
 		}
 	}
 
-	if (!connection && NM_IN_SET (ctype, G_TYPE_INVALID, NM_TYPE_SETTING_WIREGUARD)) {
+	if (   !connection
+	    && !wireguard_first
+	    && NM_IN_SET (ctype, G_TYPE_INVALID, NM_TYPE_SETTING_WIREGUARD)) {
 #if NM_CHECK_VERSION(1, 40, 0)
 		G_GNUC_BEGIN_IGNORE_DEPRECATIONS
 		connection = nm_conn_wireguard_import (filename, error && !*error ? error : NULL);
@@ -237,12 +428,56 @@ connection_import_from_file (const char *filename,
 #endif
 	}
 
+	import_sniff_clear (&sniff);
+
+	/* The file looked like WireGuard, so why that failed says more than
+	 * whatever the VPN plugins made of it. */
+	if (!connection && wireguard_error) {
+		g_clear_error (error);
+		g_propagate_error (error, g_steal_pointer (&wireguard_error));
+	}
+	if (!connection && !*error) {
+		g_set_error_literal (error, NMA_ERROR, NMA_ERROR_GENERIC,
+		                     _("No VPN plugin could import the file."));
+	}
+
 	if (!connection)
 		g_prefix_error (error, _("The VPN plugin failed to import the VPN connection correctly: "));
 
 	return connection;
 }
 
+void
+connection_import_result_free (ConnectionImportResult *result)
+{
+	g_free (result->filename);
+	g_clear_object (&result->connection);
+	g_clear_error (&result->error);
+	g_slice_free (ConnectionImportResult, result);
+}
+
+ConnectionImportResult *
+connection_import_one (const char *filename,
+                       GType ctype,
+                       const char *vpn_detail)
+{
+	ConnectionImportResult *result;
+	gint64 start;
+
+	result = g_slice_new0 (ConnectionImportResult);
+	result->filename = g_strdup (filename);
+
+	start = g_get_monotonic_time ();
+	result->connection = connection_import_from_file (filename, ctype, vpn_detail, &result->error);
+	result->elapsed = g_get_monotonic_time () - start;
+
+	g_debug ("import: %s: %s in %.3f ms",
+	         filename,
+	         result->connection ? "imported" : "failed",
+	         result->elapsed / 1000.0);
+	return result;
+}
+
 typedef struct {
 	GtkWindow *parent;
 	NMClient *client;
@@ -440,7 +675,7 @@ set_up_connection_type_combo (GtkComboBox *combo,
 		gboolean is_alias = FALSE;
 		uint32_t capabilities;
 
-		plugin = nm_vpn_plugin_info_get_editor_plugin (plugin_info);
+		plugin = vpn_get_editor_plugin (plugin_info);
 		if (!plugin)
 			continue;
 
@@ -78,5 +78,18 @@ NMConnection *connection_import_from_file (const char *filename,
                                            const char *vpn_detail,
                                            GError **error);
 
+typedef struct {
+	char *filename;
+	NMConnection *connection;
+	GError *error;
+	gint64 elapsed; /* microseconds */
+} ConnectionImportResult;
+
+void connection_import_result_free (ConnectionImportResult *result);
+
+ConnectionImportResult *connection_import_one (const char *filename,
+                                               GType ctype,
+                                               const char *vpn_detail);
+
 #endif  /* __CONNECTION_HELPERS_H__ */
 
@@ -12,7 +12,6 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
-#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -27,6 +26,16 @@
 #define COL_NEXT_HOP 2
 #define COL_METRIC  3
 #define COL_LAST COL_METRIC
+#define COL_INVALID 4 /* hidden: INVALID_* flags of the row */
+
+#define INVALID_CHECKED (1 << 8)
+#define INVALID_COLUMN(col) (1 << (col))
+#define INVALID_ANY (INVALID_COLUMN (COL_ADDRESS) | INVALID_COLUMN (COL_PREFIX) | \
+                     INVALID_COLUMN (COL_NEXT_HOP) | INVALID_COLUMN (COL_METRIC))
+
+#define INVALID_ROWS_TAG "invalid-rows"
+#define UPDATING_TAG     "updating-invalid"
+#define PROGRESS_TAG     "update-progress"
 
 /* Variables to temporarily save last edited cell value
  * from routes treeview (cancelling issues) */
@@ -34,14 +43,76 @@ static char *last_edited = NULL; /* cell text */
 static char *last_path = NULL;   /* row in treeview */
 static int last_column = -1;     /* column in treeview */
 
+static guint
+get_row_invalid (GtkTreeModel *model, GtkTreeIter *iter)
+{
+	char *cells[UTILS_ROUTE_N_CELLS] = { NULL, };
+	guint invalid;
+	int i;
+
+	/* The columns are in the order of the cells, and so are the bits of
+	 * the invalid cells. */
+	G_STATIC_ASSERT (   COL_ADDRESS == UTILS_ROUTE_CELL_DEST
+	                 && COL_PREFIX == UTILS_ROUTE_CELL_PREFIX
+	                 && COL_NEXT_HOP == UTILS_ROUTE_CELL_NEXT_HOP
+	                 && COL_METRIC == UTILS_ROUTE_CELL_METRIC);
+
+	gtk_tree_model_get (model, iter,
+	                    COL_ADDRESS, &cells[COL_ADDRESS],
+	                    COL_PREFIX, &cells[COL_PREFIX],
+	                    COL_NEXT_HOP, &cells[COL_NEXT_HOP],
+	                    COL_METRIC, &cells[COL_METRIC],
+	                    -1);
+	invalid = utils_route_cells_check (AF_INET, (const char *const *) cells, NULL, NULL, NULL, NULL);
+	for (i = 0; i < UTILS_ROUTE_N_CELLS; i++)
+		g_free (cells[i]);
+
+	return INVALID_CHECKED | invalid;
+}
+
+/* Each row caches which of its cells are invalid in COL_INVALID, and the
+ * store counts the invalid rows; only the row that changed is parsed again.
+ */
+static void
+update_invalid_rows (GtkListStore *store, guint old_invalid, guint new_invalid)
+{
+	guint n_invalid;
+
+	n_invalid = GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (store), INVALID_ROWS_TAG));
+	if (old_invalid & INVALID_ANY)
+		n_invalid--;
+	if (new_invalid & INVALID_ANY)
+		n_invalid++;
+	g_object_set_data (G_OBJECT (store), INVALID_ROWS_TAG, GUINT_TO_POINTER (n_invalid));
+}
+
+static void
+route_row_changed (GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer user_data)
+{
+	guint old_invalid, new_invalid;
+
+	if (g_object_get_data (G_OBJECT (model), UPDATING_TAG))
+		return;
+
+	gtk_tree_model_get (model, iter, COL_INVALID, &old_invalid, -1);
+	new_invalid = get_row_invalid (model, iter);
+	if (new_invalid == old_invalid)
+		return;
+
+	update_invalid_rows (GTK_LIST_STORE (model), old_invalid, new_invalid);
+
+	g_object_set_data (G_OBJECT (model), UPDATING_TAG, GUINT_TO_POINTER (TRUE));
+	gtk_list_store_set (GTK_LIST_STORE (model), iter, COL_INVALID, new_invalid, -1);
+	g_object_set_data (G_OBJECT (model), UPDATING_TAG, NULL);
+}
+
 static void
 validate (GtkWidget *dialog)
 {
 	GtkBuilder *builder;
 	GtkWidget *widget;
 	GtkTreeModel *model;
-	GtkTreeIter tree_iter;
-	gboolean valid = FALSE, iter_valid = FALSE;
+	gboolean valid;
 
 	g_return_if_fail (dialog != NULL);
 
@@ -51,39 +122,8 @@ validate (GtkWidget *dialog)
 
 	widget = GTK_WIDGET (gtk_builder_get_object (builder, "ip4_routes"));
 	model = gtk_tree_view_get_model (GTK_TREE_VIEW (widget));
-	iter_valid = gtk_tree_model_get_iter_first (model, &tree_iter);
-
-	while (iter_valid) {
-		char *addr = NULL, *next_hop = NULL;
-		guint32 prefix = 0;
-		gint64 metric = -1;
-
-		/* Address */
-		if (!utils_tree_model_get_address (model, &tree_iter, COL_ADDRESS, AF_INET, TRUE, &addr, NULL))
-			goto done;
-		g_free (addr);
-
-		/* Prefix */
-		if (!utils_tree_model_get_ip4_prefix (model, &tree_iter, COL_PREFIX, TRUE, &prefix, NULL))
-			goto done;
-		/* Don't allow zero prefix for now - that's not supported in libnm-util */
-		if (prefix == 0)
-			goto done;
-
-		/* Next hop (optional) */
-		if (!utils_tree_model_get_address (model, &tree_iter, COL_NEXT_HOP, AF_INET, FALSE, &next_hop, NULL))
-			goto done;
-		g_free (next_hop);
-
-		/* Metric (optional) */
-		if (!utils_tree_model_get_int64 (model, &tree_iter, COL_METRIC, 0, G_MAXUINT32, FALSE, &metric, NULL))
-			goto done;
-
-		iter_valid = gtk_tree_model_iter_next (model, &tree_iter);
-	}
-	valid = TRUE;
+	valid = g_object_get_data (G_OBJECT (model), INVALID_ROWS_TAG) == NULL;
 
-done:
 	widget = GTK_WIDGET (gtk_builder_get_object (builder, "ok_button"));
 	gtk_widget_set_sensitive (widget, valid);
 }
@@ -145,8 +185,13 @@ route_delete_clicked (GtkButton *button, gpointer user_data)
 	if (!selected_rows)
 		return;
 
-	if (gtk_tree_model_get_iter (model, &iter, (GtkTreePath *) selected_rows->data))
+	if (gtk_tree_model_get_iter (model, &iter, (GtkTreePath *) selected_rows->data)) {
+		guint invalid;
+
+		gtk_tree_model_get (model, &iter, COL_INVALID, &invalid, -1);
+		update_invalid_rows (GTK_LIST_STORE (model), invalid, 0);
 		gtk_list_store_remove (GTK_LIST_STORE (model), &iter);
+	}
 
 	g_list_free_full (selected_rows, (GDestroyNotify) gtk_tree_path_free);
 
@@ -159,6 +204,171 @@ route_delete_clicked (GtkButton *button, gpointer user_data)
 	validate (GTK_WIDGET (gtk_builder_get_object (builder, "ip4_routes_dialog")));
 }
 
+typedef struct {
+	GtkListStore *store;
+	guint n_added;
+} ImportRoutesData;
+
+static gboolean
+import_route (const char *dest,
+              guint prefix,
+              const char *next_hop,
+              gint64 metric,
+              gpointer user_data,
+              GError **error)
+{
+	ImportRoutesData *data = user_data;
+	struct in_addr tmp_addr;
+	char prefix_str[INET_ADDRSTRLEN], metric_str[32];
+	GtkTreeIter iter;
+	guint invalid;
+
+	/* Don't allow zero prefix for now - that's not supported in libnm-util */
+	if (prefix == 0) {
+		g_set_error_literal (error, NMA_ERROR, NMA_ERROR_GENERIC,
+		                     _("default routes are not supported"));
+		return FALSE;
+	}
+
+	tmp_addr.s_addr = nm_utils_ip4_prefix_to_netmask (prefix);
+	if (!inet_ntop (AF_INET, &tmp_addr, prefix_str, sizeof (prefix_str)))
+		*prefix_str = '\0';
+
+	if (metric >= 0)
+		g_snprintf (metric_str, sizeof (metric_str), "%lu", (unsigned long) metric);
+	else
+		metric_str[0] = '\0';
+
+	gtk_list_store_insert_with_values (data->store, &iter, -1,
+	                                   COL_ADDRESS, dest,
+	                                   COL_PREFIX, prefix_str,
+	                                   COL_NEXT_HOP, next_hop,
+	                                   COL_METRIC, metric_str,
+	                                   -1);
+
+	invalid = get_row_invalid (GTK_TREE_MODEL (data->store), &iter);
+	gtk_list_store_set (data->store, &iter, COL_INVALID, invalid, -1);
+	update_invalid_rows (data->store, 0, invalid);
+
+	data->n_added++;
+	return TRUE;
+}
+
+/* Appends the routes in @stream (`ip route` output format) to the list */
+static void
+import_routes (GtkBuilder *builder, GInputStream *stream)
+{
+	GtkWidget *dialog, *err_dialog;
+	GtkTreeView *treeview;
+	gs_unref_object GtkListStore *store = NULL;
+	gs_free_error GError *error = NULL;
+	ImportRoutesData data = { 0 };
+	GString *errors;
+	guint n_errors = 0;
+
+	dialog = GTK_WIDGET (gtk_builder_get_object (builder, "ip4_routes_dialog"));
+	treeview = GTK_TREE_VIEW (gtk_builder_get_object (builder, "ip4_routes"));
+	store = g_object_ref (GTK_LIST_STORE (gtk_tree_view_get_model (treeview)));
+
+	/* Detach the model so that the view isn't updated for each row, and
+	 * let import_route() maintain COL_INVALID itself. */
+	gtk_tree_view_set_model (treeview, NULL);
+	g_object_set_data (G_OBJECT (store), UPDATING_TAG, GUINT_TO_POINTER (TRUE));
+
+	data.store = store;
+	errors = g_string_new (NULL);
+	utils_parse_routes (stream, AF_INET, import_route, &data, errors, &n_errors, &error);
+
+	g_object_set_data (G_OBJECT (store), UPDATING_TAG, NULL);
+	gtk_tree_view_set_model (treeview, GTK_TREE_MODEL (store));
+
+	if (error || n_errors) {
+		err_dialog = gtk_message_dialog_new (GTK_WINDOW (dialog),
+		                                     GTK_DIALOG_DESTROY_WITH_PARENT | GTK_DIALOG_MODAL,
+		                                     GTK_MESSAGE_WARNING,
+		                                     GTK_BUTTONS_CLOSE,
+		                                     ngettext ("Imported %u route, but some could not be imported",
+		                                               "Imported %u routes, but some could not be imported",
+		                                               data.n_added),
+		                                     data.n_added);
+		gtk_message_dialog_format_secondary_text (GTK_MESSAGE_DIALOG (err_dialog), "%s",
+		                                          error ? error->message : errors->str);
+		gtk_dialog_run (GTK_DIALOG (err_dialog));
+		gtk_widget_destroy (err_dialog);
+	}
+	g_string_free (errors, TRUE);
+
+	validate (dialog);
+}
+
+static void
+paste_text_received (GtkClipboard *clipboard, const char *text, gpointer user_data)
+{
+	gs_unref_object GtkBuilder *builder = user_data;
+	gs_unref_object GInputStream *stream = NULL;
+
+	if (!text)
+		return;
+
+	stream = g_memory_input_stream_new_from_data (text, -1, NULL);
+	import_routes (builder, stream);
+}
+
+static void
+route_paste_clicked (GtkButton *button, gpointer user_data)
+{
+	GtkClipboard *clipboard;
+
+	clipboard = gtk_widget_get_clipboard (GTK_WIDGET (button), GDK_SELECTION_CLIPBOARD);
+	gtk_clipboard_request_text (clipboard, paste_text_received, g_object_ref (user_data));
+}
+
+static void
+route_import_clicked (GtkButton *button, gpointer user_data)
+{
+	GtkBuilder *builder = GTK_BUILDER (user_data);
+	GtkWidget *dialog, *chooser;
+	gs_free char *filename = NULL;
+
+	dialog = GTK_WIDGET (gtk_builder_get_object (builder, "ip4_routes_dialog"));
+	chooser = gtk_file_chooser_dialog_new (_("Select file to import"),
+	                                       GTK_WINDOW (dialog),
+	                                       GTK_FILE_CHOOSER_ACTION_OPEN,
+	                                       _("_Cancel"), GTK_RESPONSE_CANCEL,
+	                                       _("_Open"), GTK_RESPONSE_ACCEPT,
+	                                       NULL);
+	gtk_window_set_modal (GTK_WINDOW (chooser), TRUE);
+
+	if (gtk_dialog_run (GTK_DIALOG (chooser)) == GTK_RESPONSE_ACCEPT)
+		filename = gtk_file_chooser_get_filename (GTK_FILE_CHOOSER (chooser));
+	gtk_widget_destroy (chooser);
+
+	if (filename) {
+		gs_unref_object GFile *file = g_file_new_for_path (filename);
+		gs_unref_object GFileInputStream *stream = NULL;
+		gs_free_error GError *error = NULL;
+
+		stream = g_file_read (file, NULL, &error);
+		if (!stream) {
+			GtkWidget *err_dialog;
+
+			err_dialog = gtk_message_dialog_new (GTK_WINDOW (dialog),
+			                                     GTK_DIALOG_DESTROY_WITH_PARENT | GTK_DIALOG_MODAL,
+			                                     GTK_MESSAGE_ERROR,
+			                                     GTK_BUTTONS_CLOSE,
+			                                     _("Could not read routes from “%s”"),
+			                                     filename);
+			gtk_message_dialog_format_secondary_text (GTK_MESSAGE_DIALOG (err_dialog), "%s",
+			                                          error->message);
+			gtk_dialog_run (GTK_DIALOG (err_dialog));
+			gtk_widget_destroy (err_dialog);
+			return;
+		}
+
+		import_routes (builder, G_INPUT_STREAM (stream));
+	}
+}
+
 static void
 list_selection_changed (GtkTreeSelection *selection, gpointer user_data)
 {
@@ -307,57 +517,20 @@ static gboolean
 cell_changed_cb (GtkEditable *editable,
                  gpointer user_data)
 {
+	const char *cells[UTILS_ROUTE_N_CELLS] = { NULL, };
 	char *cell_text;
 	guint column;
 	GdkRGBA rgba;
-	gboolean value_valid = FALSE;
+	gboolean value_valid;
 	const char *colorname = NULL;
 
 	cell_text = gtk_editable_get_chars (editable, 0, -1);
 
-	/* The Netmask column can also contain prefix */
 	column = GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (user_data), "column"));
 
-	if (column == COL_PREFIX) {
-		/* The COL_PREFIX can contain IP address or prefix */
-		guint32 tmp_prefix;
-
-		errno = 0;
-
-		/* Is it a prefix? */
-		if (!strchr (cell_text, '.')) {
-			tmp_prefix = strtol (cell_text, NULL, 10);
-			if (*cell_text && !errno && tmp_prefix > 0 && tmp_prefix <= 32)
-				value_valid = TRUE;
-		} else {
-			struct in_addr tmp_addr;
-
-			/* Is it a netmask? */
-			if (inet_pton (AF_INET, cell_text, &tmp_addr) > 0)
-				value_valid = TRUE;
-		}
-	} else if (column == COL_METRIC) {
-		long int tmp_int;
-
-		errno = 0;
-		tmp_int = strtol (cell_text, NULL, 10);
-		if (errno || tmp_int < 0 || tmp_int > G_MAXUINT32)
-			value_valid = FALSE;
-		else
-			value_valid = TRUE;
-	} else {
-		struct in_addr tmp_addr = { 0 };
-
-		if (inet_pton (AF_INET, cell_text, &tmp_addr) > 0)
-			value_valid = TRUE;
-
-		/* 0.0.0.0 is not accepted for address */
-		if (column == COL_ADDRESS && tmp_addr.s_addr == 0)
-			value_valid = FALSE;
-		/* Consider empty next_hop as valid */
-		if (!*cell_text && column == COL_NEXT_HOP)
-			value_valid = TRUE;
-	}
+	/* Same rules as for the whole row, see get_row_invalid() */
+	cells[column] = cell_text;
+	value_valid = !(utils_route_cells_check (AF_INET, cells, NULL, NULL, NULL, NULL) & (1 << column));
 
 	/* Change cell's background color while editing */
 	colorname = value_valid ? "lightgreen" : "red";
@@ -561,27 +734,15 @@ cell_error_data_func (GtkTreeViewColumn *tree_column,
 {
 	guint32 col = GPOINTER_TO_UINT (data);
 	char *value = NULL;
-	char *addr, *next_hop;
-	guint32 prefix;
-	gint64 metric;
 	const char *color = "red";
-	gboolean invalid = FALSE;
-
-	if (col == COL_ADDRESS)
-		invalid = !utils_tree_model_get_address (tree_model, iter, COL_ADDRESS, AF_INET, TRUE, &addr, &value);
-	else if (col == COL_PREFIX)
-		invalid =    !utils_tree_model_get_ip4_prefix (tree_model, iter, COL_PREFIX, TRUE, &prefix, &value)
-		          || prefix == 0;
-	else if (col == COL_NEXT_HOP)
-		invalid = !utils_tree_model_get_address (tree_model, iter, COL_NEXT_HOP, AF_INET, FALSE, &next_hop, &value);
-	else if (col == COL_METRIC)
-		invalid = !utils_tree_model_get_int64 (tree_model, iter, COL_METRIC, 0, G_MAXUINT32, FALSE, &metric, &value);
-	else
-		g_warn_if_reached ();
+	guint invalid;
 
-	if (invalid)
+	gtk_tree_model_get (tree_model, iter, COL_INVALID, &invalid, -1);
+
+	if (invalid & INVALID_COLUMN (col)) {
+		gtk_tree_model_get (tree_model, iter, col, &value, -1);
 		utils_set_cell_background (cell, color, value);
-	else
+	} else
 		utils_set_cell_background (cell, NULL, NULL);
 	g_free (value);
 }
@@ -630,7 +791,8 @@ ip4_routes_dialog_new (NMSettingIPConfig *s_ip4, gboolean automatic)
 
 	ok_button = GTK_WIDGET (gtk_builder_get_object (builder, "ok_button"));
 
-	store = gtk_list_store_new (4, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING);
+	store = gtk_list_store_new (5, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_UINT);
+	g_signal_connect (store, "row-changed", G_CALLBACK (route_row_changed), NULL);
 
 	/* Add existing routes */
 	for (i = 0; i < nm_setting_ip_config_get_num_routes (s_ip4); i++) {
@@ -762,6 +924,12 @@ ip4_routes_dialog_new (NMSettingIPConfig *s_ip4, gboolean automatic)
 	gtk_widget_set_sensitive (widget, FALSE);
 	g_signal_connect (widget, "clicked", G_CALLBACK (route_delete_clicked), builder);
 
+	widget = GTK_WIDGET (gtk_builder_get_object (builder, "ip4_route_paste_button"));
+	g_signal_connect (widget, "clicked", G_CALLBACK (route_paste_clicked), builder);
+
+	widget = GTK_WIDGET (gtk_builder_get_object (builder, "ip4_route_import_button"));
+	g_signal_connect (widget, "clicked", G_CALLBACK (route_import_clicked), builder);
+
 	widget = GTK_WIDGET (gtk_builder_get_object (builder, "ip4_ignore_auto_routes"));
 	gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (widget),
 	                              nm_setting_ip_config_get_ignore_auto_routes (s_ip4));
@@ -777,81 +945,135 @@ ip4_routes_dialog_new (NMSettingIPConfig *s_ip4, gboolean automatic)
 	return dialog;
 }
 
+typedef struct {
+	NMSettingIPConfig *setting;
+	gboolean ignore_auto_routes;
+	gboolean never_default;
+} UpdateSettingData;
+
+static void
+update_setting_data_free (UpdateSettingData *data)
+{
+	g_object_unref (data->setting);
+	g_slice_free (UpdateSettingData, data);
+}
+
+static void
+update_setting_progress (guint done, guint total, gpointer user_data)
+{
+	GTask *task = user_data;
+	GtkWidget *dialog = g_task_get_source_object (task);
+	GtkProgressBar *progress;
+
+	progress = g_object_get_data (G_OBJECT (dialog), PROGRESS_TAG);
+	if (progress)
+		gtk_progress_bar_set_fraction (progress, (double) done / total);
+}
+
+static void
+update_setting_done (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+	gs_unref_object GTask *task = user_data;
+	UpdateSettingData *data = g_task_get_task_data (task);
+	gs_unref_ptrarray GPtrArray *routes = NULL;
+	GError *error = NULL;
+	guint n_invalid = 0;
+
+	routes = utils_routes_from_model_finish (result, &n_invalid, &error);
+	if (!routes) {
+		g_task_return_error (task, error);
+		return;
+	}
+
+	if (n_invalid)
+		g_warning ("%s: skipped %u invalid IPv4 route(s)", __func__, n_invalid);
+
+	/* Routes are already validated and unique, so set them in one go
+	 * rather than through nm_setting_ip_config_add_route(). */
+	g_object_set (data->setting,
+	              NM_SETTING_IP_CONFIG_ROUTES, routes,
+	              NM_SETTING_IP_CONFIG_IGNORE_AUTO_ROUTES, data->ignore_auto_routes,
+	              NM_SETTING_IP_CONFIG_NEVER_DEFAULT, data->never_default,
+	              NULL);
+
+	g_task_return_boolean (task, TRUE);
+}
+
+/**
+ * ip4_routes_dialog_update_setting_async:
+ * @dialog: the routes dialog
+ * @s_ip4: the setting to update
+ * @callback: called when @s_ip4 has been updated
+ * @user_data: data for @callback
+ *
+ * Converts the routes in @dialog in a worker thread and then replaces the
+ * routes of @s_ip4 with them.  The dialog can't be edited meanwhile and
+ * shows the progress; destroying it cancels the update.
+ */
 void
-ip4_routes_dialog_update_setting (GtkWidget *dialog, NMSettingIPConfig *s_ip4)
+ip4_routes_dialog_update_setting_async (GtkWidget *dialog,
+                                        NMSettingIPConfig *s_ip4,
+                                        GAsyncReadyCallback callback,
+                                        gpointer user_data)
 {
+	gs_unref_object GCancellable *cancellable = NULL;
 	GtkBuilder *builder;
-	GtkWidget *widget;
+	GtkWidget *widget, *progress;
 	GtkTreeModel *model;
-	GtkTreeIter tree_iter;
-	gboolean iter_valid;
+	UpdateSettingData *data;
+	GTask *task;
 
-	g_return_if_fail (dialog != NULL);
-	g_return_if_fail (s_ip4 != NULL);
+	g_return_if_fail (GTK_IS_DIALOG (dialog));
+	g_return_if_fail (NM_IS_SETTING_IP_CONFIG (s_ip4));
 
 	builder = g_object_get_data (G_OBJECT (dialog), "builder");
-	g_return_if_fail (builder != NULL);
 	g_return_if_fail (GTK_IS_BUILDER (builder));
 
-	widget = GTK_WIDGET (gtk_builder_get_object (builder, "ip4_routes"));
-	model = gtk_tree_view_get_model (GTK_TREE_VIEW (widget));
-	iter_valid = gtk_tree_model_get_iter_first (model, &tree_iter);
-
-	nm_setting_ip_config_clear_routes (s_ip4);
+	data = g_slice_new0 (UpdateSettingData);
+	data->setting = g_object_ref (s_ip4);
 
-	while (iter_valid) {
-		char *addr = NULL, *next_hop = NULL;
-		guint32 prefix = 0;
-		gint64 metric = -1;
-		NMIPRoute *route;
-
-		/* Address */
-		if (!utils_tree_model_get_address (model, &tree_iter, COL_ADDRESS, AF_INET, TRUE, &addr, NULL)) {
-			g_warning ("%s: IPv4 address missing or invalid!", __func__);
-			goto next;
-		}
+	widget = GTK_WIDGET (gtk_builder_get_object (builder, "ip4_ignore_auto_routes"));
+	data->ignore_auto_routes = gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (widget));
 
-		/* Prefix */
-		if (!utils_tree_model_get_ip4_prefix (model, &tree_iter, COL_PREFIX, TRUE, &prefix, NULL)) {
-			g_warning ("%s: IPv4 prefix/netmask missing or invalid!", __func__);
-			g_free (addr);
-			goto next;
-		}
+	widget = GTK_WIDGET (gtk_builder_get_object (builder, "ip4_never_default"));
+	data->never_default = gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (widget));
 
-		/* Next hop (optional) */
-		if (!utils_tree_model_get_address (model, &tree_iter, COL_NEXT_HOP, AF_INET, FALSE, &next_hop, NULL)) {
-			g_warning ("%s: IPv4 next hop invalid!", __func__);
-			g_free (addr);
-			goto next;
-		}
+	cancellable = g_cancellable_new ();
+	g_signal_connect_object (dialog, "destroy",
+	                         G_CALLBACK (g_cancellable_cancel), cancellable,
+	                         G_CONNECT_SWAPPED);
 
-		/* Metric (optional) */
-		if (!utils_tree_model_get_int64 (model, &tree_iter, COL_METRIC, 0, G_MAXUINT32, FALSE, &metric, NULL)) {
-			g_warning ("%s: IPv4 metric invalid!", __func__);
-			g_free (addr);
-			g_free (next_hop);
-			goto next;
-		}
+	task = g_task_new (dialog, cancellable, callback, user_data);
+	g_task_set_source_tag (task, ip4_routes_dialog_update_setting_async);
+	g_task_set_task_data (task, data, (GDestroyNotify) update_setting_data_free);
 
-		route = nm_ip_route_new (AF_INET, addr, prefix, next_hop, metric, NULL);
-		nm_setting_ip_config_add_route (s_ip4, route);
-		nm_ip_route_unref (route);
+	/* Only Cancel stays usable while the routes are converted */
+	widget = GTK_WIDGET (gtk_builder_get_object (builder, "vbox2"));
+	gtk_widget_set_sensitive (widget, FALSE);
+	widget = GTK_WIDGET (gtk_builder_get_object (builder, "ok_button"));
+	gtk_widget_set_sensitive (widget, FALSE);
 
-		g_free (addr);
-		g_free (next_hop);
+	progress = gtk_progress_bar_new ();
+	gtk_progress_bar_set_text (GTK_PROGRESS_BAR (progress), _("Checking routes…"));
+	gtk_progress_bar_set_show_text (GTK_PROGRESS_BAR (progress), TRUE);
+	gtk_box_pack_end (GTK_BOX (gtk_dialog_get_content_area (GTK_DIALOG (dialog))),
+	                  progress, FALSE, FALSE, 0);
+	gtk_widget_show (progress);
+	g_object_set_data (G_OBJECT (dialog), PROGRESS_TAG, progress);
 
-	next:
-		iter_valid = gtk_tree_model_iter_next (model, &tree_iter);
-	}
+	widget = GTK_WIDGET (gtk_builder_get_object (builder, "ip4_routes"));
+	model = gtk_tree_view_get_model (GTK_TREE_VIEW (widget));
+	utils_routes_from_model_async (model, AF_INET, cancellable,
+	                               update_setting_progress,
+	                               update_setting_done, task);
+}
 
-	widget = GTK_WIDGET (gtk_builder_get_object (builder, "ip4_ignore_auto_routes"));
-	g_object_set (s_ip4, NM_SETTING_IP_CONFIG_IGNORE_AUTO_ROUTES,
-	              gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (widget)),
-	              NULL);
+gboolean
+ip4_routes_dialog_update_setting_finish (GtkWidget *dialog,
+                                         GAsyncResult *result,
+                                         GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, dialog), FALSE);
 
-	widget = GTK_WIDGET (gtk_builder_get_object (builder, "ip4_never_default"));
-	g_object_set (s_ip4, NM_SETTING_IP_CONFIG_NEVER_DEFAULT,
-	              gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (widget)),
-	              NULL);
+	return g_task_propagate_boolean (G_TASK (result), error);
 }
-
@@ -18,6 +18,13 @@
 
 GtkWidget *ip4_routes_dialog_new (NMSettingIPConfig *s_ip4, gboolean automatic);
 
-void ip4_routes_dialog_update_setting (GtkWidget *dialog, NMSettingIPConfig *s_ip4);
+void ip4_routes_dialog_update_setting_async (GtkWidget *dialog,
+                                             NMSettingIPConfig *s_ip4,
+                                             GAsyncReadyCallback callback,
+                                             gpointer user_data);
+
+gboolean ip4_routes_dialog_update_setting_finish (GtkWidget *dialog,
+                                                  GAsyncResult *result,
+                                                  GError **error);
 
 #endif /* IP4_ROUTES_DIALOG_H */
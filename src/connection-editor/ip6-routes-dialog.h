@@ -18,6 +18,13 @@
 
 GtkWidget *ip6_routes_dialog_new (NMSettingIPConfig *s_ip6, gboolean automatic);
 
-void ip6_routes_dialog_update_setting (GtkWidget *dialog, NMSettingIPConfig *s_ip6);
+void ip6_routes_dialog_update_setting_async (GtkWidget *dialog,
+                                             NMSettingIPConfig *s_ip6,
+                                             GAsyncReadyCallback callback,
+                                             gpointer user_data);
+
+gboolean ip6_routes_dialog_update_setting_finish (GtkWidget *dialog,
+                                                  GAsyncResult *result,
+                                                  GError **error);
 
 #endif /* IP6_ROUTES_DIALOG_H */
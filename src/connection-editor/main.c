@@ -94,6 +94,255 @@ handle_arguments (GApplication *application,
 	return show_list;
 }
 
+/*************************************************/
+
+/* Headless bulk import (--import-dir).  The files are parsed by a pool of
+ * worker threads (each VPN plugin is called by one thread at a time, see
+ * connection_import_from_file()), and the results are added to
+ * NetworkManager with a bounded number of add requests in flight.
+ */
+
+#define BULK_IMPORT_MAX_PENDING 16
+
+/* g_application_command_line_set_exit_status() is not seen when the
+ * command line was handled by this very instance; main() returns this. */
+static int bulk_import_exit_status;
+
+typedef struct {
+	GApplication *application;
+	GApplicationCommandLine *command_line;
+	NMClient *client;
+	GMainContext *context;
+	GThreadPool *pool;
+	GQueue to_add;
+
+	guint n_files;
+	guint n_parsed;
+	guint n_pending;
+	guint n_added;
+	guint n_failed;
+
+	gint64 start;
+	gint64 parse_time;
+} BulkImport;
+
+typedef struct {
+	BulkImport *bulk;
+	ConnectionImportResult *result;
+} BulkImportItem;
+
+static void bulk_import_pump (BulkImport *bulk);
+
+static void
+bulk_import_finish (BulkImport *bulk)
+{
+	double elapsed = (g_get_monotonic_time () - bulk->start) / (double) G_USEC_PER_SEC;
+
+	g_application_command_line_print (bulk->command_line,
+	                                  "Imported %u of %u files in %.2f s (%.1f files/s), %u failed.\n"
+	                                  "Parsing took %.2f s in total.\n",
+	                                  bulk->n_added,
+	                                  bulk->n_files,
+	                                  elapsed,
+	                                  elapsed > 0 ? bulk->n_files / elapsed : 0.0,
+	                                  bulk->n_failed,
+	                                  bulk->parse_time / (double) G_USEC_PER_SEC);
+	bulk_import_exit_status = bulk->n_failed ? 1 : 0;
+	g_application_command_line_set_exit_status (bulk->command_line, bulk_import_exit_status);
+
+	if (bulk->pool)
+		g_thread_pool_free (bulk->pool, FALSE, TRUE);
+	g_main_context_unref (bulk->context);
+	g_clear_object (&bulk->client);
+	g_object_unref (bulk->command_line);
+	g_application_release (bulk->application);
+	g_slice_free (BulkImport, bulk);
+}
+
+static void
+bulk_import_check_done (BulkImport *bulk)
+{
+	if (   bulk->n_parsed == bulk->n_files
+	    && bulk->n_pending == 0
+	    && g_queue_is_empty (&bulk->to_add))
+		bulk_import_finish (bulk);
+}
+
+static void
+bulk_import_added_cb (GObject *client, GAsyncResult *result, gpointer user_data)
+{
+	BulkImportItem *item = user_data;
+	BulkImport *bulk = item->bulk;
+	gs_unref_object NMRemoteConnection *remote = NULL;
+	gs_free_error GError *error = NULL;
+
+	remote = nm_client_add_connection_finish (NM_CLIENT (client), result, &error);
+	if (remote) {
+		bulk->n_added++;
+	} else {
+		bulk->n_failed++;
+		g_application_command_line_printerr (bulk->command_line, "%s: %s\n",
+		                                     item->result->filename, error->message);
+	}
+
+	connection_import_result_free (item->result);
+	g_slice_free (BulkImportItem, item);
+
+	bulk->n_pending--;
+	bulk_import_pump (bulk);
+	bulk_import_check_done (bulk);
+}
+
+static void
+bulk_import_pump (BulkImport *bulk)
+{
+	BulkImportItem *item;
+
+	while (   bulk->n_pending < BULK_IMPORT_MAX_PENDING
+	       && (item = g_queue_pop_head (&bulk->to_add))) {
+		bulk->n_pending++;
+		nm_client_add_connection_async (bulk->client,
+		                                item->result->connection,
+		                                TRUE,
+		                                NULL,
+		                                bulk_import_added_cb,
+		                                item);
+	}
+}
+
+static gboolean
+bulk_import_parsed (gpointer user_data)
+{
+	BulkImportItem *item = user_data;
+	BulkImport *bulk = item->bulk;
+
+	bulk->n_parsed++;
+	bulk->parse_time += item->result->elapsed;
+
+	if (item->result->connection) {
+		g_queue_push_tail (&bulk->to_add, item);
+		bulk_import_pump (bulk);
+	} else {
+		bulk->n_failed++;
+		g_application_command_line_printerr (bulk->command_line, "%s: %s\n",
+		                                     item->result->filename,
+		                                     item->result->error ? item->result->error->message : "unknown error");
+		connection_import_result_free (item->result);
+		g_slice_free (BulkImportItem, item);
+	}
+
+	bulk_import_check_done (bulk);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+bulk_import_worker (gpointer data, gpointer user_data)
+{
+	gs_free char *filename = data;
+	BulkImportItem *item;
+	GSource *source;
+
+	item = g_slice_new0 (BulkImportItem);
+	item->bulk = user_data;
+	item->result = connection_import_one (filename, G_TYPE_INVALID, NULL);
+
+	/* Not g_main_context_invoke(), which could run it right here */
+	source = g_idle_source_new ();
+	g_source_set_callback (source, bulk_import_parsed, item, NULL);
+	g_source_attach (source, item->bulk->context);
+	g_source_unref (source);
+}
+
+static GPtrArray *
+bulk_import_list_files (const char *path, GError **error)
+{
+	GPtrArray *files;
+	const char *name;
+	GDir *dir;
+
+	dir = g_dir_open (path, 0, error);
+	if (!dir)
+		return NULL;
+
+	files = g_ptr_array_new_with_free_func (g_free);
+	while ((name = g_dir_read_name (dir))) {
+		char *filename = g_build_filename (path, name, NULL);
+
+		if (g_file_test (filename, G_FILE_TEST_IS_REGULAR))
+			g_ptr_array_add (files, filename);
+		else
+			g_free (filename);
+	}
+	g_dir_close (dir);
+
+	g_ptr_array_sort (files, (GCompareFunc) nm_strcmp_p);
+	return files;
+}
+
+static int
+bulk_import (GApplication *application,
+             GApplicationCommandLine *command_line,
+             const char *import_dir)
+{
+	gs_unref_object GFile *file = NULL;
+	gs_unref_ptrarray GPtrArray *files = NULL;
+	gs_free char *path = NULL;
+	GError *error = NULL;
+	BulkImport *bulk;
+	guint i;
+
+	file = g_application_command_line_create_file_for_arg (command_line, import_dir);
+	path = g_file_get_path (file);
+	if (!path) {
+		g_application_command_line_printerr (command_line, "%s is not a local directory\n",
+		                                     import_dir);
+		return 1;
+	}
+
+	files = bulk_import_list_files (path, &error);
+	if (!files) {
+		g_application_command_line_printerr (command_line, "Failed to read %s: %s\n",
+		                                     import_dir, error->message);
+		g_error_free (error);
+		return 1;
+	}
+
+	bulk = g_slice_new0 (BulkImport);
+	g_queue_init (&bulk->to_add);
+	bulk->client = nm_client_new (NULL, &error);
+	if (!bulk->client) {
+		g_application_command_line_printerr (command_line, "Failed to connect to NetworkManager: %s\n",
+		                                     error->message);
+		g_error_free (error);
+		g_slice_free (BulkImport, bulk);
+		return 1;
+	}
+
+	g_application_hold (application);
+	bulk->application = application;
+	bulk->context = g_main_context_ref_thread_default ();
+	bulk->command_line = g_object_ref (command_line);
+	bulk->n_files = files->len;
+	bulk->start = g_get_monotonic_time ();
+
+	/* Reading the plugin list (which also loads the editor plugins) is
+	 * not thread-safe; get it done before the workers need it. */
+	vpn_get_plugin_infos ();
+
+	if (files->len) {
+		bulk->pool = g_thread_pool_new (bulk_import_worker, bulk,
+		                                g_get_num_processors (),
+		                                FALSE, NULL);
+		for (i = 0; i < files->len; i++)
+			g_thread_pool_push (bulk->pool, g_strdup (files->pdata[i]), NULL);
+	} else
+		bulk_import_check_done (bulk);
+
+	return 0;
+}
+
+/*************************************************/
+
 static gboolean
 signal_handler (gpointer user_data)
 {
@@ -152,6 +401,8 @@ editor_startup (GApplication *application, gpointer user_data)
 	GtkApplication *app = GTK_APPLICATION (application);
 	NMConnectionList *list;
 
+	vpn_plugin_infos_preload ();
+
 	g_action_map_add_action_entries (G_ACTION_MAP (app), app_entries,
 	                                 G_N_ELEMENTS (app_entries), app);
 
@@ -192,7 +443,7 @@ editor_command_line (GApplication *application,
 	gint argc;
 	GOptionContext *opt_ctx = NULL;
 	GError *error = NULL;
-	gs_free char *type = NULL, *uuid = NULL, *import = NULL;
+	gs_free char *type = NULL, *uuid = NULL, *import = NULL, *import_dir = NULL;
 	gboolean create = FALSE, show = FALSE;
 	int ret = 1;
 	GOptionEntry entries[] = {
@@ -201,6 +452,7 @@ editor_command_line (GApplication *application,
 		{ "show",   's', 0, G_OPTION_ARG_NONE,   &show,   "Show a given connection type page", NULL },
 		{ "edit",   'e', 0, G_OPTION_ARG_STRING, &uuid,   "Edit an existing connection with a given UUID", "UUID" },
 		{ "import", 'i', 0, G_OPTION_ARG_STRING, &import, "Import a VPN connection from given file", NULL },
+		{ "import-dir", 0, 0, G_OPTION_ARG_FILENAME, &import_dir, "Import all VPN and WireGuard connections from a directory without showing the UI", "DIRECTORY" },
 		{ NULL }
 	};
 
@@ -221,6 +473,11 @@ editor_command_line (GApplication *application,
 		type = g_strdup (NM_SETTING_GSM_SETTING_NAME);
 	}
 
+	if (import_dir) {
+		ret = bulk_import (application, command_line, import_dir);
+		goto out;
+	}
+
 	if (handle_arguments (application, type, create, show, uuid, import))
 		g_application_activate (application);
 
@@ -236,6 +493,7 @@ main (int argc, char *argv[])
 {
 	gs_unref_object GtkApplication *app = NULL;
 	GOptionContext *opt_ctx;
+	int ret;
 	GOptionEntry entries[] = {
 		/* This is not passed over D-Bus. */
 		{ "keep-above", 0, G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_NONE, &nm_ce_keep_above, NULL, NULL },
@@ -263,5 +521,6 @@ main (int argc, char *argv[])
 	g_unix_signal_add (SIGTERM, signal_handler, app);
 	g_unix_signal_add (SIGINT, signal_handler, app);
 
-	return g_application_run (G_APPLICATION (app), argc, argv);
+	ret = g_application_run (G_APPLICATION (app), argc, argv);
+	return ret ?: bulk_import_exit_status;
 }
@@ -67,6 +67,11 @@ static guint editor_signals[EDITOR_LAST_SIGNAL] = { 0 };
 
 static GHashTable *active_editors;
 
+/* Open editors by the UUID and by the interface name of their connection,
+ * for nm_connection_editor_get_controller() */
+static GHashTable *active_editors_by_uuid;
+static GHashTable *active_editors_by_ifname;
+
 static gboolean nm_connection_editor_set_connection (NMConnectionEditor *editor,
                                                      NMConnection *connection,
                                                      GError **error);
@@ -76,8 +81,13 @@ struct GetSecretsInfo {
 	CEPage *page;
 	char *setting_name;
 	gboolean canceled;
+	gboolean concurrent;
 };
 
+/* Set once an authorization challenge was seen; secrets are then requested
+ * one setting at a time.  See get_secrets_for_page(). */
+static gboolean serialize_secrets_calls;
+
 #define SECRETS_TAG "secrets-setting-name"
 #define ORDER_TAG "page-order"
 
@@ -354,13 +364,21 @@ connection_editor_validate (NMConnectionEditor *editor)
 	recheck_relabel (editor);
 
 	for (iter = editor->pages; iter; iter = g_slist_next (iter)) {
-		if (!ce_page_validate (CE_PAGE (iter->data), editor->connection, &error)) {
-			if (!validation_error) {
-				validation_error = g_strdup_printf (_("Invalid setting %s: %s"),
-				                                    CE_PAGE (iter->data)->title,
-				                                    error->message);
+		CEPage *page = CE_PAGE (iter->data);
+		char *page_error = NULL;
+
+		if (!g_hash_table_lookup_extended (editor->page_validation, page, NULL, (gpointer *) &page_error)) {
+			if (!ce_page_validate (page, editor->connection, &error)) {
+				page_error = g_strdup (error->message);
+				g_clear_error (&error);
 			}
-			g_clear_error (&error);
+			g_hash_table_insert (editor->page_validation, page, page_error);
+		}
+
+		if (page_error && !validation_error) {
+			validation_error = g_strdup_printf (_("Invalid setting %s: %s"),
+			                                    page->title,
+			                                    page_error);
 		}
 	}
 
@@ -454,6 +472,7 @@ nm_connection_editor_init (NMConnectionEditor *editor)
 	gtk_builder_connect_signals (editor->builder, editor);
 
 	editor->inter_page_hash = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) destroy_inter_page_item);
+	editor->page_validation = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
 }
 
 static void
@@ -463,6 +482,67 @@ get_secrets_info_free (GetSecretsInfo *info)
 	g_free (info);
 }
 
+static void
+editor_index_remove (NMConnectionEditor *editor)
+{
+	GHashTableIter iter;
+	NMConnectionEditor *other;
+
+	if (editor->indexed_uuid) {
+		if (g_hash_table_lookup (active_editors_by_uuid, editor->indexed_uuid) == editor)
+			g_hash_table_remove (active_editors_by_uuid, editor->indexed_uuid);
+		nm_clear_g_free (&editor->indexed_uuid);
+	}
+
+	if (editor->indexed_ifname) {
+		if (g_hash_table_lookup (active_editors_by_ifname, editor->indexed_ifname) == editor) {
+			g_hash_table_remove (active_editors_by_ifname, editor->indexed_ifname);
+
+			/* Another open editor may have the same interface name */
+			g_hash_table_iter_init (&iter, active_editors);
+			while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &other)) {
+				if (other != editor && nm_streq0 (other->indexed_ifname, editor->indexed_ifname)) {
+					g_hash_table_insert (active_editors_by_ifname,
+					                     g_strdup (other->indexed_ifname), other);
+					break;
+				}
+			}
+		}
+		nm_clear_g_free (&editor->indexed_ifname);
+	}
+}
+
+static void
+editor_index_add (NMConnectionEditor *editor)
+{
+	const char *str;
+
+	if (!active_editors_by_uuid) {
+		active_editors_by_uuid = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+		active_editors_by_ifname = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	}
+
+	str = nm_connection_get_uuid (editor->orig_connection);
+	if (str) {
+		editor->indexed_uuid = g_strdup (str);
+		g_hash_table_insert (active_editors_by_uuid, g_strdup (str), editor);
+	}
+
+	str = nm_connection_get_interface_name (editor->orig_connection);
+	if (str) {
+		editor->indexed_ifname = g_strdup (str);
+		if (!g_hash_table_contains (active_editors_by_ifname, str))
+			g_hash_table_insert (active_editors_by_ifname, g_strdup (str), editor);
+	}
+}
+
+static void
+orig_connection_changed (NMConnection *connection, NMConnectionEditor *editor)
+{
+	editor_index_remove (editor);
+	editor_index_add (editor);
+}
+
 static void
 dispose (GObject *object)
 {
@@ -470,8 +550,11 @@ dispose (GObject *object)
 
 	editor->disposed = TRUE;
 
-	if (active_editors && editor->orig_connection)
+	if (active_editors && editor->orig_connection) {
+		g_signal_handlers_disconnect_by_func (editor->orig_connection, orig_connection_changed, editor);
+		editor_index_remove (editor);
 		g_hash_table_remove (active_editors, editor->orig_connection);
+	}
 
 	g_slist_free_full (editor->initializing_pages, g_object_unref);
 	editor->initializing_pages = NULL;
@@ -482,6 +565,10 @@ dispose (GObject *object)
 	/* Mark any in-progress secrets call as canceled; it will clean up after itself. */
 	if (editor->secrets_call)
 		editor->secrets_call->canceled = TRUE;
+	while (editor->concurrent_secrets_calls) {
+		((GetSecretsInfo *) editor->concurrent_secrets_calls->data)->canceled = TRUE;
+		editor->concurrent_secrets_calls = g_slist_delete_link (editor->concurrent_secrets_calls, editor->concurrent_secrets_calls);
+	}
 
 	while (editor->pending_secrets_calls) {
 		get_secrets_info_free ((GetSecretsInfo *) editor->pending_secrets_calls->data);
@@ -504,6 +591,7 @@ dispose (GObject *object)
 	g_clear_object (&editor->client);
 
 	g_clear_pointer (&editor->last_validation_error, g_free);
+	g_clear_pointer (&editor->page_validation, g_hash_table_unref);
 
 	if (editor->inter_page_hash) {
 		g_hash_table_destroy (editor->inter_page_hash);
@@ -595,6 +683,11 @@ nm_connection_editor_new (GtkWindow *parent_window,
 		active_editors = g_hash_table_new_full (NULL, NULL, g_object_unref, NULL);
 	g_hash_table_insert (active_editors, g_object_ref (connection), editor);
 
+	/* The interface name changes when the connection is saved */
+	editor_index_add (editor);
+	g_signal_connect (editor->orig_connection, NM_CONNECTION_CHANGED,
+	                  G_CALLBACK (orig_connection_changed), editor);
+
 	return editor;
 }
 
@@ -608,12 +701,11 @@ nm_connection_editor_get (NMConnection *connection)
 NMConnectionEditor *
 nm_connection_editor_get_controller (NMConnection *port)
 {
-	GHashTableIter iter;
-	gpointer connection, editor;
+	NMConnectionEditor *editor;
 	NMSettingConnection *s_con;
 	const char *controller;
 
-	if (!active_editors)
+	if (!active_editors_by_uuid)
 		return NULL;
 
 	s_con = nm_connection_get_setting_connection (port);
@@ -621,15 +713,10 @@ nm_connection_editor_get_controller (NMConnection *port)
 	if (!controller)
 		return NULL;
 
-	g_hash_table_iter_init (&iter, active_editors);
-	while (g_hash_table_iter_next (&iter, &connection, &editor)) {
-		if (!g_strcmp0 (controller, nm_connection_get_uuid (connection)))
-			return editor;
-		if (!g_strcmp0 (controller, nm_connection_get_interface_name (connection)))
-			return editor;
-	}
-
-	return NULL;
+	editor = g_hash_table_lookup (active_editors_by_uuid, controller);
+	if (!editor)
+		editor = g_hash_table_lookup (active_editors_by_ifname, controller);
+	return editor;
 }
 
 NMConnection *
@@ -640,6 +727,8 @@ nm_connection_editor_get_connection (NMConnectionEditor *editor)
 	return editor->orig_connection;
 }
 
+static void connection_editor_queue_validate (NMConnectionEditor *editor);
+
 static void
 populate_connection_ui (NMConnectionEditor *editor)
 {
@@ -652,25 +741,27 @@ populate_connection_ui (NMConnectionEditor *editor)
 	gtk_entry_set_text (GTK_ENTRY (name), s_con ? nm_setting_connection_get_id (s_con) : NULL);
 	gtk_widget_set_tooltip_text (name, nm_connection_get_uuid (editor->connection));
 
-	g_signal_connect_swapped (name, "changed", G_CALLBACK (connection_editor_validate), editor);
+	g_signal_connect_swapped (name, "changed", G_CALLBACK (connection_editor_queue_validate), editor);
 
 	connection_editor_validate (editor);
 }
 
 static void
-page_changed (CEPage *page, gpointer user_data)
+run_inter_page_changes (NMConnectionEditor *editor)
 {
-	NMConnectionEditor *editor = NM_CONNECTION_EDITOR (user_data);
 	GSList *iter;
 
+	if (!editor->inter_page_pending)
+		return;
+	editor->inter_page_pending = FALSE;
+
 	/* Do page interdependent changes */
 	for (iter = editor->pages; iter; iter = g_slist_next (iter))
 		ce_page_inter_page_change (CE_PAGE (iter->data));
+	g_hash_table_remove_all (editor->page_validation);
 
 	if (editor_is_initialized (editor))
 		nm_connection_editor_inter_page_clear_data (editor);
-
-	connection_editor_validate (editor);
 }
 
 static gboolean
@@ -679,10 +770,35 @@ idle_validate (gpointer user_data)
 	NMConnectionEditor *editor = NM_CONNECTION_EDITOR (user_data);
 
 	editor->validate_id = 0;
+	run_inter_page_changes (editor);
 	connection_editor_validate (editor);
 	return FALSE;
 }
 
+/* Validates once the pending input has been processed but before the next
+ * redraw, so that a burst of changes only costs one run. */
+static void
+connection_editor_queue_validate (NMConnectionEditor *editor)
+{
+	if (editor->validate_id)
+		return;
+	editor->validate_id = g_idle_add_full (GDK_PRIORITY_REDRAW - 1, idle_validate, editor, NULL);
+}
+
+static void
+page_changed (CEPage *page, gpointer user_data)
+{
+	NMConnectionEditor *editor = NM_CONNECTION_EDITOR (user_data);
+
+	/* A page's validity may depend on other pages' settings (e.g. the
+	 * Wi-Fi security page looks at the SSID and mode), so any change
+	 * invalidates all of the cached results.
+	 */
+	g_hash_table_remove_all (editor->page_validation);
+	editor->inter_page_pending = TRUE;
+	connection_editor_queue_validate (editor);
+}
+
 static void
 recheck_initialization (NMConnectionEditor *editor)
 {
@@ -809,6 +925,14 @@ page_new_editor (CEPage *page, NMConnectionEditor *new_editor, gpointer user_dat
 }
 
 static void request_secrets (GetSecretsInfo *info);
+static void queue_secrets_call (NMConnectionEditor *self, GetSecretsInfo *info);
+
+static gboolean
+is_authorization_error (GError *error)
+{
+	return    g_error_matches (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_PERMISSION_DENIED)
+	       || g_error_matches (error, G_DBUS_ERROR, G_DBUS_ERROR_ACCESS_DENIED);
+}
 
 static void
 get_secrets_cb (GObject *object,
@@ -830,6 +954,24 @@ get_secrets_cb (GObject *object,
 
 	self = info->self;
 
+	if (info->concurrent) {
+		self->concurrent_secrets_calls = g_slist_remove (self->concurrent_secrets_calls, info);
+
+		/* The request may have lost a race for the authorization with the
+		 * other ones; ask again in the serialized way. */
+		if (is_authorization_error (error)) {
+			g_clear_error (&error);
+			serialize_secrets_calls = TRUE;
+			info->concurrent = FALSE;
+			queue_secrets_call (self, info);
+			return;
+		}
+
+		ce_page_complete_init (info->page, info->setting_name, secrets, error);
+		get_secrets_info_free (info);
+		return;
+	}
+
 	/* Complete this secrets request; completion can actually dispose of the
 	 * dialog if there was an error.
 	 */
@@ -879,8 +1021,24 @@ get_secrets_for_page (NMConnectionEditor *self,
 	 */
 	/* NOTE: PolicyKit-gnome 0.95 now serializes auth requests as of this commit:
 	 * http://git.gnome.org/cgit/PolicyKit-gnome/commit/?id=f32cb7faa7197b9db55b569677732742c3c7fdc1
+	 *
+	 * So all pages ask at once, to not wait for one round-trip after the
+	 * other; only if a request fails authorization, it and all later ones
+	 * take the serialized path.
 	 */
+	if (!serialize_secrets_calls) {
+		info->concurrent = TRUE;
+		self->concurrent_secrets_calls = g_slist_prepend (self->concurrent_secrets_calls, info);
+		request_secrets (info);
+		return;
+	}
 
+	queue_secrets_call (self, info);
+}
+
+static void
+queue_secrets_call (NMConnectionEditor *self, GetSecretsInfo *info)
+{
 	/* If there's already an in-progress call, queue up the new one */
 	if (self->secrets_call)
 		self->pending_secrets_calls = g_slist_append (self->pending_secrets_calls, info);
@@ -1249,7 +1407,12 @@ ok_button_clicked_cb (GtkWidget *widget, gpointer user_data)
 		return;
 
 	/* Validate one last time to ensure all pages update the connection */
+	nm_clear_g_source (&self->validate_id);
+	run_inter_page_changes (self);
+	g_hash_table_remove_all (self->page_validation);
 	connection_editor_validate (self);
+	if (self->last_validation_error)
+		return;
 
 	/* Perform page specific actions before the connection is saved */
 	for (iter = self->pages; iter; iter = g_slist_next (iter))
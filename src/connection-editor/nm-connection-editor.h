@@ -36,8 +36,13 @@ typedef struct {
 	NMConnection *orig_connection;
 	gboolean is_new_connection;
 
+	/* Keys of the editor in the UUID and interface name indices */
+	char *indexed_uuid;
+	char *indexed_ifname;
+
 	GetSecretsInfo *secrets_call;
 	GSList *pending_secrets_calls;
+	GSList *concurrent_secrets_calls;
 
 	GtkWidget *all_checkbutton;
 	NMClientPermissionResult can_modify;
@@ -57,6 +62,12 @@ typedef struct {
 	gboolean busy;
 	gboolean init_run;
 	guint validate_id;
+	gboolean inter_page_pending;
+
+	/* CEPage -> its last validation error (NULL if it validated).  Emptied
+	 * whenever any page changes, so only revalidations caused by something
+	 * else (the name entry, permissions) reuse it. */
+	GHashTable *page_validation;
 
 	char *last_validation_error;
 
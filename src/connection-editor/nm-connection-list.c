@@ -20,6 +20,7 @@
 #include "nm-connection-list.h"
 #include "ce-polkit.h"
 #include "connection-helpers.h"
+#include "ce-utils.h"
 
 extern gboolean nm_ce_keep_above;
 
@@ -42,9 +43,27 @@ struct _NMConnectionListPrivate {
 	GtkTreeSortable *sortable;
 	GType displayed_type;
 
+	/* NMRemoteConnection -> ConnectionRow */
+	GHashTable *rows;
+
+	/* Casefolded search string (NULL when not searching), and the number
+	 * of connections of each type (by COL_ORDER) that match it */
+	char *search_key;
+	guint *type_match_counts;
+	guint n_types;
+
+	/* "Last used" texts by bucket, and the local day number of
+	 * last_used_second that the buckets are computed against */
+	GHashTable *last_used_strings;
+	gint64 last_used_second;
+	guint32 last_used_today;
+	guint last_used_refresh_id;
+
 	NMClient *client;
 
 	gboolean populated;
+	gboolean populating;
+	gint64 populate_start;
 };
 
 #define NM_CONNECTION_LIST_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), \
@@ -62,6 +81,44 @@ G_DEFINE_TYPE_WITH_CODE (NMConnectionList, nm_connection_list, GTK_TYPE_APPLICAT
 #define COL_GTYPE1     5
 #define COL_GTYPE2     6
 #define COL_ORDER      7
+#define COL_ROW        8
+
+/* Above this many rows changing visibility, a full refilter is cheaper
+ * than emitting row-changed (which needs a path) for each of them. */
+#define SEARCH_INCREMENTAL_MAX 128
+
+/* Per-connection data that is looked up from the model without copying;
+ * the COL_ROW column of each connection row points here.  GtkTreeStore
+ * iters stay valid for as long as the row exists.
+ */
+typedef struct {
+	GtkTreeIter iter;
+	NMRemoteConnection *connection;
+	char *search_key;
+	UtilsSortKeys sort_keys;
+	int type_order;
+	gboolean matches;
+	guint last_used_bucket;
+} ConnectionRow;
+
+static void connection_changed (NMRemoteConnection *connection, gpointer user_data);
+
+static void
+connection_row_free (ConnectionRow *row)
+{
+	g_free (row->search_key);
+	utils_sort_keys_clear (&row->sort_keys);
+	g_slice_free (ConnectionRow, row);
+}
+
+static char *
+search_key_new (const char *str)
+{
+	gs_free char *normalized = NULL;
+
+	normalized = g_utf8_normalize (str, -1, G_NORMALIZE_ALL);
+	return g_utf8_casefold (normalized ? normalized : str, -1);
+}
 
 static NMRemoteConnection *
 get_active_connection (GtkTreeView *treeview)
@@ -96,105 +153,209 @@ get_iter_for_connection (NMConnectionList *list,
                          NMRemoteConnection *connection,
                          GtkTreeIter *iter)
 {
-	GtkTreeIter types_iter;
 	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (list);
+	ConnectionRow *row;
 
-	if (!gtk_tree_model_get_iter_first (priv->model, &types_iter))
+	row = g_hash_table_lookup (priv->rows, connection);
+	if (!row)
 		return FALSE;
 
-	do {
-		if (!gtk_tree_model_iter_children (priv->model, iter, &types_iter))
-			continue;
+	*iter = row->iter;
+	return TRUE;
+}
 
-		do {
-			NMRemoteConnection *candidate = NULL;
+/* Updates row->matches against the current search and keeps the per-type
+ * counts in sync.  Returns TRUE if the row's match state changed. */
+static gboolean
+row_update_match (NMConnectionListPrivate *priv, ConnectionRow *row, gboolean removed)
+{
+	gboolean matches;
 
-			gtk_tree_model_get (priv->model, iter,
-			                    COL_CONNECTION, &candidate,
-			                    -1);
-			if (candidate == connection) {
-				g_object_unref (candidate);
-				return TRUE;
-			}
-			g_object_unref (candidate);
-		} while (gtk_tree_model_iter_next (priv->model, iter));
-	} while (gtk_tree_model_iter_next (priv->model, &types_iter));
+	if (removed)
+		matches = FALSE;
+	else if (!priv->search_key)
+		matches = TRUE;
+	else
+		matches = strstr (row->search_key, priv->search_key) != NULL;
 
-	return FALSE;
+	if (matches == row->matches)
+		return FALSE;
+
+	row->matches = matches;
+	if (matches)
+		priv->type_match_counts[row->type_order]++;
+	else
+		priv->type_match_counts[row->type_order]--;
+	return TRUE;
 }
 
-static char *
-format_last_used (guint64 timestamp)
+static void
+refilter (NMConnectionList *self)
 {
-	GTimeVal now_tv;
-	GDate *now, *last;
-	char *last_used = NULL;
+	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (self);
 
-	if (!timestamp)
-		return g_strdup (_("never"));
+	gtk_tree_model_filter_refilter (priv->filter);
+}
+
+static void
+emit_row_changed (GtkTreeModel *model, GtkTreeIter *iter)
+{
+	GtkTreePath *path;
 
-	g_get_current_time (&now_tv);
-	now = g_date_new ();
-	g_date_set_time_val (now, &now_tv);
+	path = gtk_tree_model_get_path (model, iter);
+	gtk_tree_model_row_changed (model, path, iter);
+	gtk_tree_path_free (path);
+}
 
-	last = g_date_new ();
-	g_date_set_time_t (last, (time_t) timestamp);
+/* How long ago a connection was last used, rounded the way it is shown.
+ * Rows only need their text refreshed when their bucket changes. */
+typedef enum {
+	LAST_USED_NEVER,
+	LAST_USED_NOW,
+	LAST_USED_MINUTES,
+	LAST_USED_HOURS,
+	LAST_USED_TODAY,
+	LAST_USED_DAYS,
+	LAST_USED_MONTHS,
+	LAST_USED_YEARS,
+} LastUsedUnit;
+
+#define LAST_USED_BUCKET(unit, n)   (((guint) (unit) << 24) | ((n) & 0xffffff))
+#define LAST_USED_BUCKET_UNIT(b)    ((b) >> 24)
+#define LAST_USED_BUCKET_N(b)       ((b) & 0xffffff)
+
+/* Refresh interval of the "Last Used" column, in seconds */
+#define LAST_USED_REFRESH_INTERVAL 60
+
+static guint
+get_last_used_bucket (NMConnectionList *self, guint64 timestamp)
+{
+	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (self);
+	gint64 now;
+	GDate date;
+	guint32 last;
+	guint days, months, years;
+
+	if (!timestamp)
+		return LAST_USED_BUCKET (LAST_USED_NEVER, 0);
+
+	now = g_get_real_time () / G_USEC_PER_SEC;
 
 	/* timestamp is now or in the future */
-	if (now_tv.tv_sec <= timestamp) {
-		last_used = g_strdup (_("now"));
-		goto out;
+	if (now <= timestamp)
+		return LAST_USED_BUCKET (LAST_USED_NOW, 0);
+
+	if (now != priv->last_used_second) {
+		g_date_clear (&date, 1);
+		g_date_set_time_t (&date, (time_t) now);
+		priv->last_used_today = g_date_get_julian (&date);
+		priv->last_used_second = now;
 	}
 
-	if (g_date_compare (now, last) <= 0) {
+	g_date_clear (&date, 1);
+	g_date_set_time_t (&date, (time_t) timestamp);
+	last = g_date_get_julian (&date);
+
+	if (priv->last_used_today <= last) {
 		guint minutes, hours;
 
 		/* Same day */
 
-		minutes = (now_tv.tv_sec - timestamp) / 60;
-		if (minutes == 0) {
-			last_used = g_strdup (_("now"));
-			goto out;
-		}
+		minutes = (now - timestamp) / 60;
+		if (minutes == 0)
+			return LAST_USED_BUCKET (LAST_USED_NOW, 0);
 
-		hours = (now_tv.tv_sec - timestamp) / 3600;
+		hours = (now - timestamp) / 3600;
 		if (hours == 0) {
 			/* less than an hour ago */
-			last_used = g_strdup_printf (ngettext ("%d minute ago", "%d minutes ago", minutes), minutes);
-			goto out;
+			return LAST_USED_BUCKET (LAST_USED_MINUTES, minutes);
 		}
 
-		last_used = g_strdup_printf (ngettext ("%d hour ago", "%d hours ago", hours), hours);
-	} else {
-		guint days, months, years;
+		return LAST_USED_BUCKET (LAST_USED_HOURS, hours);
+	}
 
-		days = g_date_get_julian (now) - g_date_get_julian (last);
-		if (days == 0) {
-			last_used = g_strdup ("today");
-			goto out;
-		}
+	days = priv->last_used_today - last;
+	if (days == 0)
+		return LAST_USED_BUCKET (LAST_USED_TODAY, 0);
 
-		months = days / 30;
-		if (months == 0) {
-			last_used = g_strdup_printf (ngettext ("%d day ago", "%d days ago", days), days);
-			goto out;
-		}
+	months = days / 30;
+	if (months == 0)
+		return LAST_USED_BUCKET (LAST_USED_DAYS, days);
 
-		years = days / 365;
-		if (years == 0) {
-			last_used = g_strdup_printf (ngettext ("%d month ago", "%d months ago", months), months);
-			goto out;
-		}
+	years = days / 365;
+	if (years == 0)
+		return LAST_USED_BUCKET (LAST_USED_MONTHS, months);
+
+	return LAST_USED_BUCKET (LAST_USED_YEARS, years);
+}
 
-		last_used = g_strdup_printf (ngettext ("%d year ago", "%d years ago", years), years);
+static const char *
+format_last_used (NMConnectionList *self, guint bucket)
+{
+	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (self);
+	guint n = LAST_USED_BUCKET_N (bucket);
+	char *last_used;
+
+	last_used = g_hash_table_lookup (priv->last_used_strings, GUINT_TO_POINTER (bucket));
+	if (last_used)
+		return last_used;
+
+	switch (LAST_USED_BUCKET_UNIT (bucket)) {
+	case LAST_USED_NEVER:
+		last_used = g_strdup (_("never"));
+		break;
+	case LAST_USED_NOW:
+		last_used = g_strdup (_("now"));
+		break;
+	case LAST_USED_MINUTES:
+		last_used = g_strdup_printf (ngettext ("%d minute ago", "%d minutes ago", n), n);
+		break;
+	case LAST_USED_HOURS:
+		last_used = g_strdup_printf (ngettext ("%d hour ago", "%d hours ago", n), n);
+		break;
+	case LAST_USED_TODAY:
+		last_used = g_strdup ("today");
+		break;
+	case LAST_USED_DAYS:
+		last_used = g_strdup_printf (ngettext ("%d day ago", "%d days ago", n), n);
+		break;
+	case LAST_USED_MONTHS:
+		last_used = g_strdup_printf (ngettext ("%d month ago", "%d months ago", n), n);
+		break;
+	case LAST_USED_YEARS:
+	default:
+		last_used = g_strdup_printf (ngettext ("%d year ago", "%d years ago", n), n);
+		break;
 	}
 
-out:
-	g_date_free (now);
-	g_date_free (last);
+	g_hash_table_insert (priv->last_used_strings, GUINT_TO_POINTER (bucket), last_used);
 	return last_used;
 }
 
+static gboolean
+refresh_last_used (gpointer user_data)
+{
+	NMConnectionList *self = user_data;
+	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (self);
+	GHashTableIter iter;
+	ConnectionRow *row;
+	guint bucket;
+
+	g_hash_table_iter_init (&iter, priv->rows);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &row)) {
+		bucket = get_last_used_bucket (self, row->sort_keys.timestamp);
+		if (bucket == row->last_used_bucket)
+			continue;
+
+		row->last_used_bucket = bucket;
+		gtk_tree_store_set (GTK_TREE_STORE (priv->model), &row->iter,
+		                    COL_LAST_USED, format_last_used (self, bucket),
+		                    -1);
+	}
+
+	return G_SOURCE_CONTINUE;
+}
+
 static void
 update_connection_row (NMConnectionList *self,
                        GtkTreeIter *iter,
@@ -202,23 +363,36 @@ update_connection_row (NMConnectionList *self,
 {
 	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (self);
 	NMSettingConnection *s_con;
-	char *last_used, *id;
+	ConnectionRow *row;
+	guint bucket;
+	char *id;
 
 	s_con = nm_connection_get_setting_connection (NM_CONNECTION (connection));
 	g_assert (s_con);
 
-	last_used = format_last_used (nm_setting_connection_get_timestamp (s_con));
+	bucket = get_last_used_bucket (self, nm_setting_connection_get_timestamp (s_con));
+
+	row = g_hash_table_lookup (priv->rows, connection);
+	if (row) {
+		g_free (row->search_key);
+		row->search_key = search_key_new (nm_setting_connection_get_id (s_con));
+		utils_sort_keys_set (&row->sort_keys,
+		                     nm_setting_connection_get_id (s_con),
+		                     nm_setting_connection_get_timestamp (s_con));
+		row->last_used_bucket = bucket;
+		row_update_match (priv, row, FALSE);
+	}
+
 	id = g_markup_escape_text (nm_setting_connection_get_id (s_con), -1);
 	gtk_tree_store_set (GTK_TREE_STORE (priv->model), iter,
 	                    COL_ID, id,
-	                    COL_LAST_USED, last_used,
+	                    COL_LAST_USED, format_last_used (self, bucket),
 	                    COL_TIMESTAMP, nm_setting_connection_get_timestamp (s_con),
 	                    COL_CONNECTION, connection,
 	                    -1);
-	g_free (last_used);
 	g_free (id);
 
-	gtk_tree_model_filter_refilter (priv->filter);
+	refilter (self);
 }
 
 static void
@@ -497,14 +671,67 @@ start_search (GtkTreeView *treeview, gpointer user_data)
 	return TRUE;
 }
 
+/* GtkSearchEntry only emits search-changed once typing pauses, so this
+ * already runs debounced. */
 static void
 search_changed (GtkSearchEntry *entry, gpointer user_data)
 {
 	NMConnectionList *list = user_data;
 	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (list);
+	gs_free char *old_key = NULL;
+	gs_unref_ptrarray GPtrArray *changed = NULL;
+	gs_free gboolean *type_changed = NULL;
+	const char *text;
+	gboolean narrowing;
+	GHashTableIter hiter;
+	ConnectionRow *row;
+	GtkTreeIter parent_iter;
+	guint i;
+
+	old_key = g_steal_pointer (&priv->search_key);
+	text = gtk_entry_get_text (GTK_ENTRY (priv->search_entry));
+	if (gtk_search_bar_get_search_mode (priv->search_bar) && text[0])
+		priv->search_key = search_key_new (text);
+
+	if (g_strcmp0 (old_key, priv->search_key) == 0)
+		return;
 
-	gtk_tree_model_filter_refilter (priv->filter);
-	gtk_tree_view_expand_all (priv->connection_list);
+	/* If the new search contains the old one, only rows that matched
+	 * before can possibly match now. */
+	narrowing = priv->search_key && (!old_key || strstr (priv->search_key, old_key));
+
+	changed = g_ptr_array_new ();
+	g_hash_table_iter_init (&hiter, priv->rows);
+	while (g_hash_table_iter_next (&hiter, NULL, (gpointer *) &row)) {
+		if (narrowing && !row->matches)
+			continue;
+		if (row_update_match (priv, row, FALSE))
+			g_ptr_array_add (changed, row);
+	}
+
+	if (!narrowing || changed->len > SEARCH_INCREMENTAL_MAX) {
+		refilter (list);
+		if (!narrowing)
+			gtk_tree_view_expand_all (priv->connection_list);
+		return;
+	}
+
+	/* Rows only disappear when narrowing.  Hide them first, then the type
+	 * nodes that are left without any match. */
+	type_changed = g_new0 (gboolean, priv->n_types);
+	for (i = 0; i < changed->len; i++) {
+		row = changed->pdata[i];
+		emit_row_changed (priv->model, &row->iter);
+	}
+	for (i = 0; i < changed->len; i++) {
+		row = changed->pdata[i];
+		if (   priv->type_match_counts[row->type_order] > 0
+		    || type_changed[row->type_order])
+			continue;
+		type_changed[row->type_order] = TRUE;
+		if (gtk_tree_model_iter_parent (priv->model, &parent_iter, &row->iter))
+			emit_row_changed (priv->model, &parent_iter);
+	}
 }
 
 static void
@@ -519,7 +746,20 @@ dispose (GObject *object)
 	NMConnectionList *list = NM_CONNECTION_LIST (object);
 	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (list);
 
+	nm_clear_g_source (&priv->last_used_refresh_id);
 	g_clear_object (&priv->client);
+	if (priv->rows) {
+		GHashTableIter iter;
+		NMRemoteConnection *connection;
+
+		g_hash_table_iter_init (&iter, priv->rows);
+		while (g_hash_table_iter_next (&iter, (gpointer *) &connection, NULL))
+			g_signal_handlers_disconnect_by_func (connection, connection_changed, list);
+	}
+	g_clear_pointer (&priv->rows, g_hash_table_unref);
+	g_clear_pointer (&priv->last_used_strings, g_hash_table_unref);
+	g_clear_pointer (&priv->search_key, g_free);
+	g_clear_pointer (&priv->type_match_counts, g_free);
 
 	G_OBJECT_CLASS (nm_connection_list_parent_class)->dispose (object);
 }
@@ -592,80 +832,46 @@ sort_connection_types (GtkTreeModel *model, GtkTreeIter *a, GtkTreeIter *b, gpoi
 static gint
 id_sort_func (GtkTreeModel *model, GtkTreeIter *a, GtkTreeIter *b, gpointer user_data)
 {
-	NMConnection *conn_a, *conn_b;
-	gint ret;
+	ConnectionRow *row_a = NULL, *row_b = NULL;
 
-	gtk_tree_model_get (model, a, COL_CONNECTION, &conn_a, -1);
-	gtk_tree_model_get (model, b, COL_CONNECTION, &conn_b, -1);
+	gtk_tree_model_get (model, a, COL_ROW, &row_a, -1);
+	gtk_tree_model_get (model, b, COL_ROW, &row_b, -1);
 
-	if (!conn_a || !conn_b) {
-		g_assert (!conn_a && !conn_b);
+	if (!row_a || !row_b) {
+		g_assert (!row_a && !row_b);
 		return sort_connection_types (model, a, b, user_data);
 	}
 
-	ret = strcmp (nm_connection_get_id (conn_a), nm_connection_get_id (conn_b));
-	g_object_unref (conn_a);
-	g_object_unref (conn_b);
-
-	return ret;
+	return utils_sort_keys_cmp_id (&row_a->sort_keys, &row_b->sort_keys);
 }
 
 static gint
 timestamp_sort_func (GtkTreeModel *model, GtkTreeIter *a, GtkTreeIter *b, gpointer user_data)
 {
-	NMConnection *conn_a, *conn_b;
-	guint64 time_a, time_b;
+	ConnectionRow *row_a = NULL, *row_b = NULL;
 
-	gtk_tree_model_get (model, a,
-	                    COL_CONNECTION, &conn_a,
-	                    COL_TIMESTAMP, &time_a,
-	                    -1);
-	gtk_tree_model_get (model, b,
-	                    COL_CONNECTION, &conn_b,
-	                    COL_TIMESTAMP, &time_b,
-	                    -1);
+	gtk_tree_model_get (model, a, COL_ROW, &row_a, -1);
+	gtk_tree_model_get (model, b, COL_ROW, &row_b, -1);
 
-	if (!conn_a || !conn_b) {
-		g_assert (!conn_a && !conn_b);
+	if (!row_a || !row_b) {
+		g_assert (!row_a && !row_b);
 		return sort_connection_types (model, a, b, user_data);
 	}
 
-	g_object_unref (conn_a);
-	g_object_unref (conn_b);
-
-	return time_b - time_a;
+	return utils_sort_keys_cmp_timestamp (&row_a->sort_keys, &row_b->sort_keys);
 }
 
 static gboolean
 has_visible_children (NMConnectionList *self, GtkTreeModel *model, GtkTreeIter *parent)
 {
 	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (self);
-	GtkTreeIter iter;
-	const char *search;
-	char *id = NULL;
+	int order;
 
-	if (!gtk_search_bar_get_search_mode (priv->search_bar))
+	if (!priv->search_key)
 		return gtk_tree_model_iter_has_child  (model, parent);
 
-	if (!gtk_tree_model_iter_children (model, &iter, parent))
-		return FALSE;
-
-	search = gtk_entry_get_text (GTK_ENTRY (priv->search_entry));
-	do {
-		gtk_tree_model_get (model, &iter, COL_ID, &id, -1);
-		if (!id) {
-			/* gtk_tree_store_append() inserts an empty row, ignore
-			 * it until it is fully populated. */
-			continue;
-		}
-		if (strcasestr (id, search) != NULL) {
-			g_free (id);
-			return TRUE;
-		}
-		g_free (id);
-	} while (gtk_tree_model_iter_next (model, &iter));
-
-	return FALSE;
+	gtk_tree_model_get (model, parent, COL_ORDER, &order, -1);
+	return priv->type_match_counts[order] > 0;
 }
 
 static gboolean
@@ -675,31 +881,32 @@ tree_model_visible_func (GtkTreeModel *model,
 {
 	NMConnectionList *self = user_data;
 	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (self);
-	gs_unref_object NMConnection *connection = NULL;
+	ConnectionRow *row = NULL;
+	NMConnection *connection;
 	NMSettingConnection *s_con;
 	const char *controller;
 	const char *port_type;
-	gs_free char *id = NULL;
 
-	gtk_tree_model_get (model, iter,
-	                    COL_ID, &id,
-	                    COL_CONNECTION, &connection,
-	                    -1);
-	if (!connection) {
+	/* Everything gets refiltered once the bulk load is done */
+	if (priv->populating)
+		return FALSE;
+
+	gtk_tree_model_get (model, iter, COL_ROW, &row, -1);
+	if (!row) {
 		/* Top-level type nodes are visible iff they have visible children */
 		return has_visible_children (self, model, iter);
 	}
 
-	if (   gtk_search_bar_get_search_mode (priv->search_bar)
-	    && strcasestr (id, gtk_entry_get_text (GTK_ENTRY (priv->search_entry))) == NULL)
+	if (!row->matches)
 		return FALSE;
 
 	/* A connection node is visible unless it is a slave to a known
 	 * bond or team or bridge.
 	 */
+	connection = NM_CONNECTION (row->connection);
 	s_con = nm_connection_get_setting_connection (connection);
 	if (   !s_con
-	    || !nm_remote_connection_get_visible (NM_REMOTE_CONNECTION (connection)))
+	    || !nm_remote_connection_get_visible (row->connection))
 		return FALSE;
 
 	controller = nm_setting_connection_get_master (s_con);
@@ -725,18 +932,13 @@ static gboolean
 connection_list_equal (GtkTreeModel *model, gint column, const gchar *key,
                        GtkTreeIter *iter, gpointer user_data)
 {
-	gs_free char *id = NULL;
-	gs_unref_object NMConnection *connection = NULL;
+	ConnectionRow *row = NULL;
 
-	gtk_tree_model_get (model, iter,
-	                    COL_ID, &id,
-	                    COL_CONNECTION, &connection,
-	                    -1);
-
-	if (!connection)
+	gtk_tree_model_get (model, iter, COL_ROW, &row, -1);
+	if (!row)
 		return TRUE;
 
-	return strcasestr (id, key) == NULL;
+	return strcasestr (nm_connection_get_id (NM_CONNECTION (row->connection)), key) == NULL;
 }
 
 static void
@@ -752,14 +954,19 @@ initialize_treeview (NMConnectionList *self)
 	int i;
 
 	/* Model */
-	priv->model = GTK_TREE_MODEL (gtk_tree_store_new (8, G_TYPE_STRING,
+	priv->model = GTK_TREE_MODEL (gtk_tree_store_new (9, G_TYPE_STRING,
 	                                                     G_TYPE_STRING,
 	                                                     G_TYPE_UINT64,
 	                                                     G_TYPE_OBJECT,
 	                                                     G_TYPE_GTYPE,
 	                                                     G_TYPE_GTYPE,
 	                                                     G_TYPE_GTYPE,
-	                                                     G_TYPE_INT));
+	                                                     G_TYPE_INT,
+	                                                     G_TYPE_POINTER));
+
+	priv->rows = g_hash_table_new_full (NULL, NULL,
+	                                    g_object_unref,
+	                                    (GDestroyNotify) connection_row_free);
 
 	/* Filter */
 	priv->filter = GTK_TREE_MODEL_FILTER (gtk_tree_model_filter_new (priv->model, NULL));
@@ -825,6 +1032,14 @@ initialize_treeview (NMConnectionList *self)
 		                    -1);
 		g_free (id);
 	}
+	priv->n_types = i;
+	priv->type_match_counts = g_new0 (guint, priv->n_types);
+
+	/* Keep the "Last Used" column current */
+	priv->last_used_strings = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+	priv->last_used_refresh_id = g_timeout_add_seconds (LAST_USED_REFRESH_INTERVAL,
+	                                                    refresh_last_used,
+	                                                    self);
 }
 
 static void
@@ -855,10 +1070,14 @@ connection_removed (NMClient *client,
 	GtkTreeIter iter, parent_iter;
 
 	if (get_iter_for_connection (self, connection, &iter)) {
+		row_update_match (priv, g_hash_table_lookup (priv->rows, connection), TRUE);
 		gtk_tree_model_iter_parent (priv->model, &parent_iter, &iter);
+		/* The store row points to the ConnectionRow; drop it first */
 		gtk_tree_store_remove (GTK_TREE_STORE (priv->model), &iter);
+		g_signal_handlers_disconnect_by_func (connection, connection_changed, self);
+		g_hash_table_remove (priv->rows, connection);
 	}
-	gtk_tree_model_filter_refilter (priv->filter);
+	refilter (self);
 }
 
 static void
@@ -911,6 +1130,87 @@ get_parent_iter_for_connection (NMConnectionList *list,
 	return FALSE;
 }
 
+static gboolean
+type_row_is_displayed (NMConnectionList *self, GtkTreeIter *parent_iter)
+{
+	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (self);
+	GType added_type0, added_type1, added_type2;
+
+	if (!priv->displayed_type)
+		return TRUE;
+
+	gtk_tree_model_get (priv->model, parent_iter,
+	                    COL_GTYPE0, &added_type0,
+	                    COL_GTYPE1, &added_type1,
+	                    COL_GTYPE2, &added_type2,
+	                    -1);
+	return    added_type0 == priv->displayed_type
+	       || added_type1 == priv->displayed_type
+	       || added_type2 == priv->displayed_type;
+}
+
+static void
+expand_type_row (NMConnectionList *self, GtkTreeIter *parent_iter)
+{
+	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (self);
+	GtkTreePath *path, *filtered_path;
+
+	path = gtk_tree_model_get_path (priv->model, parent_iter);
+	filtered_path = gtk_tree_model_filter_convert_child_path_to_path (priv->filter, path);
+	if (filtered_path)
+		gtk_tree_view_expand_row (priv->connection_list, filtered_path, FALSE);
+	gtk_tree_path_free (filtered_path);
+	gtk_tree_path_free (path);
+}
+
+static gboolean
+add_connection_row (NMConnectionList *self,
+                    NMRemoteConnection *connection,
+                    GtkTreeIter *out_parent_iter)
+{
+	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (self);
+	ConnectionRow *row;
+	NMSettingConnection *s_con;
+	char *id;
+
+	if (g_hash_table_contains (priv->rows, connection))
+		return FALSE;
+
+	if (!get_parent_iter_for_connection (self, connection, out_parent_iter))
+		return FALSE;
+
+	s_con = nm_connection_get_setting_connection (NM_CONNECTION (connection));
+
+	row = g_slice_new0 (ConnectionRow);
+	row->connection = connection;
+	row->search_key = search_key_new (nm_setting_connection_get_id (s_con));
+	utils_sort_keys_set (&row->sort_keys,
+	                     nm_setting_connection_get_id (s_con),
+	                     nm_setting_connection_get_timestamp (s_con));
+	gtk_tree_model_get (priv->model, out_parent_iter, COL_ORDER, &row->type_order, -1);
+	row->last_used_bucket = get_last_used_bucket (self, row->sort_keys.timestamp);
+	row_update_match (priv, row, FALSE);
+
+	id = g_markup_escape_text (nm_setting_connection_get_id (s_con), -1);
+
+	/* Insert the row with all values at once; an empty row would confuse
+	 * tree_model_visible_func(). */
+	gtk_tree_store_insert_with_values (GTK_TREE_STORE (priv->model), &row->iter, out_parent_iter, -1,
+	                                   COL_ID, id,
+	                                   COL_LAST_USED, format_last_used (self, row->last_used_bucket),
+	                                   COL_TIMESTAMP, row->sort_keys.timestamp,
+	                                   COL_CONNECTION, connection,
+	                                   COL_ROW, row,
+	                                   -1);
+
+	g_free (id);
+
+	g_hash_table_insert (priv->rows, g_object_ref (connection), row);
+
+	g_signal_connect (connection, NM_CONNECTION_CHANGED, G_CALLBACK (connection_changed), self);
+	return TRUE;
+}
+
 static void
 connection_added (NMClient *client,
                   NMRemoteConnection *connection,
@@ -918,57 +1218,70 @@ connection_added (NMClient *client,
 {
 	NMConnectionList *self = NM_CONNECTION_LIST (user_data);
 	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (self);
-	GtkTreeIter parent_iter, iter;
-	NMSettingConnection *s_con;
-	char *last_used, *id;
-	gboolean expand = TRUE;
+	GtkTreeIter parent_iter;
 
-	if (!get_parent_iter_for_connection (self, connection, &parent_iter))
+	/* populate_connections() picks it up */
+	if (!priv->populated)
 		return;
 
-	s_con = nm_connection_get_setting_connection (NM_CONNECTION (connection));
+	if (!add_connection_row (self, connection, &parent_iter))
+		return;
 
-	last_used = format_last_used (nm_setting_connection_get_timestamp (s_con));
+	if (type_row_is_displayed (self, &parent_iter))
+		expand_type_row (self, &parent_iter);
 
-	id = g_markup_escape_text (nm_setting_connection_get_id (s_con), -1);
+	refilter (self);
+}
 
-	gtk_tree_store_append (GTK_TREE_STORE (priv->model), &iter, &parent_iter);
-	gtk_tree_store_set (GTK_TREE_STORE (priv->model), &iter,
-	                    COL_ID, id,
-	                    COL_LAST_USED, last_used,
-	                    COL_TIMESTAMP, nm_setting_connection_get_timestamp (s_con),
-	                    COL_CONNECTION, connection,
-	                    -1);
+static gboolean
+first_paint_cb (GtkWidget *widget, cairo_t *cr, gpointer user_data)
+{
+	NMConnectionList *self = user_data;
+	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (self);
 
-	g_free (id);
-	g_free (last_used);
+	g_debug ("Connection list first painted %.1f ms after populating started",
+	         (g_get_monotonic_time () - priv->populate_start) / 1000.0);
+	g_signal_handlers_disconnect_by_func (widget, first_paint_cb, user_data);
 
-	if (priv->displayed_type) {
-		GType added_type0, added_type1, added_type2;
+	return FALSE;
+}
 
-		gtk_tree_model_get (priv->model, &parent_iter,
-		                    COL_GTYPE0, &added_type0,
-		                    COL_GTYPE1, &added_type1,
-		                    COL_GTYPE2, &added_type2,
-		                    -1);
-		if (   added_type0 != priv->displayed_type
-		    && added_type1 != priv->displayed_type
-		    && added_type2 != priv->displayed_type)
-			expand = FALSE;
-	}
+/* Fill the list with all connections at once: rows are inserted with the
+ * view detached and the filter short-circuited, then the tree is refiltered
+ * and the type nodes expanded a single time.
+ */
+static void
+populate_connections (NMConnectionList *self)
+{
+	NMConnectionListPrivate *priv = NM_CONNECTION_LIST_GET_PRIVATE (self);
+	const GPtrArray *all_cons;
+	GtkTreeIter parent_iter;
+	int i;
 
-	if (expand) {
-		GtkTreePath *path, *filtered_path;
+	priv->populate_start = g_get_monotonic_time ();
 
-		path = gtk_tree_model_get_path (priv->model, &parent_iter);
-		filtered_path = gtk_tree_model_filter_convert_child_path_to_path (priv->filter, path);
-		gtk_tree_view_expand_row (priv->connection_list, filtered_path, FALSE);
-		gtk_tree_path_free (filtered_path);
-		gtk_tree_path_free (path);
+	gtk_tree_view_set_model (priv->connection_list, NULL);
+	priv->populating = TRUE;
+
+	all_cons = nm_client_get_connections (priv->client);
+	for (i = 0; i < all_cons->len; i++)
+		add_connection_row (self, all_cons->pdata[i], &parent_iter);
+
+	priv->populating = FALSE;
+	refilter (self);
+	gtk_tree_view_set_model (priv->connection_list, GTK_TREE_MODEL (priv->sortable));
+
+	if (gtk_tree_model_get_iter_first (priv->model, &parent_iter)) {
+		do {
+			if (   gtk_tree_model_iter_has_child (priv->model, &parent_iter)
+			    && type_row_is_displayed (self, &parent_iter))
+				expand_type_row (self, &parent_iter);
+		} while (gtk_tree_model_iter_next (priv->model, &parent_iter));
 	}
 
-	g_signal_connect (connection, NM_CONNECTION_CHANGED, G_CALLBACK (connection_changed), self);
-	gtk_tree_model_filter_refilter (priv->filter);
+	g_debug ("Connection list populated with %u connections in %.1f ms",
+	         all_cons->len, (g_get_monotonic_time () - priv->populate_start) / 1000.0);
+	g_signal_connect (priv->connection_list, "draw", G_CALLBACK (first_paint_cb), self);
 }
 
 NMConnectionList *
@@ -1139,19 +1452,15 @@ void
 nm_connection_list_present (NMConnectionList *list)
 {
 	NMConnectionListPrivate *priv;
-	const GPtrArray *all_cons;
 	GtkTreePath *path;
 	GtkTreeIter iter;
-	int i;
 
 	g_return_if_fail (NM_IS_CONNECTION_LIST (list));
 	priv = NM_CONNECTION_LIST_GET_PRIVATE (list);
 
 	if (!priv->populated) {
 		/* Fill the treeview initially */
-		all_cons = nm_client_get_connections (priv->client);
-		for (i = 0; i < all_cons->len; i++)
-			connection_added (priv->client, all_cons->pdata[i], list);
+		populate_connections (list);
 		if (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (priv->sortable), &iter)) {
 			path = gtk_tree_model_get_path (GTK_TREE_MODEL (priv->sortable), &iter);
 			gtk_tree_view_scroll_to_cell (priv->connection_list,
@@ -951,14 +951,25 @@ routes_dialog_close_cb (GtkWidget *dialog, gpointer user_data)
 	gtk_widget_destroy (dialog);
 }
 
+static void
+routes_dialog_update_cb (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+	/* Fails only when the dialog was destroyed before the update finished */
+	if (ip4_routes_dialog_update_setting_finish (GTK_WIDGET (source), result, NULL))
+		routes_dialog_close_cb (GTK_WIDGET (source), NULL);
+}
+
 static void
 routes_dialog_response_cb (GtkWidget *dialog, gint response, gpointer user_data)
 {
 	CEPageIP4 *self = CE_PAGE_IP4 (user_data);
 	CEPageIP4Private *priv = CE_PAGE_IP4_GET_PRIVATE (self);
 
-	if (response == GTK_RESPONSE_OK)
-		ip4_routes_dialog_update_setting (dialog, priv->setting);
+	if (response == GTK_RESPONSE_OK) {
+		ip4_routes_dialog_update_setting_async (dialog, priv->setting,
+		                                        routes_dialog_update_cb, NULL);
+		return;
+	}
 
 	routes_dialog_close_cb (dialog, NULL);
 }
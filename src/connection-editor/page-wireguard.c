@@ -11,6 +11,8 @@
 #include "page-wireguard.h"
 #include "nm-connection-editor.h"
 #include "nma-ui-utils.h"
+#include "ce-utils.h"
+#include "nm-utils/nm-shared-utils.h"
 
 G_DEFINE_TYPE (CEPageWireGuard, ce_page_wireguard, CE_TYPE_PAGE)
 
@@ -45,17 +47,43 @@ typedef struct {
 	GtkToggleButton *toggle_show_pk;
 	GtkButton *button_add;
 	GtkButton *button_delete;
+	GtkButton *button_import;
 
 	GtkTreeView *tree;
 	GtkTreeStore *store;
+	GtkTreeModelFilter *filter;
+	GtkSearchEntry *entry_search;
+
+	/* PeerRow of each row of the store; owns them */
+	GHashTable *rows;
+	/* PeerIndexEntry sorted by token */
+	GArray *index;
+	/* Rows matching search_key, which is NULL when not searching */
+	GHashTable *matched;
+	char *search_key;
 } CEPageWireGuardPrivate;
 
 enum {
 	COL_PUBLIC_KEY,
 	COL_ALLOWED_IPS,
+	COL_ROW,
 	N_COLUMNS,
 };
 
+/* The search matches the beginning of the public key or of any of the
+ * allowed IPs of a peer.  These tokens are kept in a sorted index, so that
+ * finding the matching rows is a binary search rather than a pass over all
+ * peers.
+ */
+typedef struct {
+	char **tokens;
+} PeerRow;
+
+typedef struct {
+	const char *token;
+	PeerRow *row;
+} PeerIndexEntry;
+
 static void
 peer_dialog_data_destroy (PeerDialogData *data)
 {
@@ -82,6 +110,108 @@ format_allowed_ips (NMWireGuardPeer *peer)
 	return string ? g_string_free (string, FALSE) : NULL;
 }
 
+static PeerRow *
+peer_row_new (NMWireGuardPeer *peer)
+{
+	PeerRow *row;
+	GPtrArray *tokens;
+	const char *str;
+	guint i, len;
+
+	tokens = g_ptr_array_new ();
+
+	str = nm_wireguard_peer_get_public_key (peer);
+	if (str && str[0])
+		g_ptr_array_add (tokens, g_ascii_strdown (str, -1));
+
+	len = nm_wireguard_peer_get_allowed_ips_len (peer);
+	for (i = 0; i < len; i++) {
+		str = nm_wireguard_peer_get_allowed_ip (peer, i, NULL);
+		if (str && str[0])
+			g_ptr_array_add (tokens, g_ascii_strdown (str, -1));
+	}
+	g_ptr_array_add (tokens, NULL);
+
+	row = g_slice_new (PeerRow);
+	row->tokens = (char **) g_ptr_array_free (tokens, FALSE);
+	return row;
+}
+
+static void
+peer_row_free (PeerRow *row)
+{
+	g_strfreev (row->tokens);
+	g_slice_free (PeerRow, row);
+}
+
+static gboolean
+peer_row_matches (PeerRow *row, const char *key)
+{
+	char **token;
+
+	for (token = row->tokens; *token; token++) {
+		if (g_str_has_prefix (*token, key))
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static int
+index_entry_cmp (gconstpointer a, gconstpointer b)
+{
+	return strcmp (((const PeerIndexEntry *) a)->token,
+	               ((const PeerIndexEntry *) b)->token);
+}
+
+/* Position of the first entry whose token is not less than @token */
+static guint
+index_lower_bound (GArray *index, const char *token)
+{
+	guint lo = 0, hi = index->len;
+
+	while (lo < hi) {
+		guint mid = lo + (hi - lo) / 2;
+
+		if (strcmp (g_array_index (index, PeerIndexEntry, mid).token, token) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static void
+index_add_row (GArray *index, PeerRow *row)
+{
+	char **token;
+
+	for (token = row->tokens; *token; token++) {
+		PeerIndexEntry entry = { *token, row };
+
+		g_array_insert_val (index, index_lower_bound (index, *token), entry);
+	}
+}
+
+static void
+index_remove_row (GArray *index, PeerRow *row)
+{
+	char **token;
+	guint pos;
+
+	for (token = row->tokens; *token; token++) {
+		for (pos = index_lower_bound (index, *token); pos < index->len; pos++) {
+			PeerIndexEntry *entry = &g_array_index (index, PeerIndexEntry, pos);
+
+			if (!nm_streq (entry->token, *token))
+				break;
+			if (entry->row == row) {
+				g_array_remove_index (index, pos);
+				break;
+			}
+		}
+	}
+}
+
 static void
 peer_dialog_update_ui (GtkWidget *dialog)
 {
@@ -235,6 +365,19 @@ peer_dialog_create (GtkWidget *toplevel, NMWireGuardPeer *peer)
 	return dialog;
 }
 
+static gboolean
+peer_visible_func (GtkTreeModel *model, GtkTreeIter *iter, gpointer user_data)
+{
+	CEPageWireGuardPrivate *priv = CE_PAGE_WIREGUARD_GET_PRIVATE (user_data);
+	PeerRow *row = NULL;
+
+	if (!priv->search_key)
+		return TRUE;
+
+	gtk_tree_model_get (model, iter, COL_ROW, &row, -1);
+	return row && g_hash_table_contains (priv->matched, row);
+}
+
 static void
 wireguard_private_init (CEPageWireGuard *self)
 {
@@ -254,10 +397,20 @@ wireguard_private_init (CEPageWireGuard *self)
 	priv->tree = GTK_TREE_VIEW (gtk_builder_get_object (builder, "tree_peers"));
 	priv->button_add = GTK_BUTTON (gtk_builder_get_object (builder, "button_add"));
 	priv->button_delete = GTK_BUTTON (gtk_builder_get_object (builder, "button_delete"));
+	priv->button_import = GTK_BUTTON (gtk_builder_get_object (builder, "button_import"));
 
 	gtk_entry_set_visibility (priv->entry_pk, FALSE);
 
-	priv->store = gtk_tree_store_new (3, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_POINTER);
+	priv->entry_search = GTK_SEARCH_ENTRY (gtk_builder_get_object (builder, "entry_search"));
+
+	priv->rows = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+	                                    (GDestroyNotify) peer_row_free, NULL);
+	priv->index = g_array_new (FALSE, FALSE, sizeof (PeerIndexEntry));
+	priv->matched = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	priv->store = gtk_tree_store_new (N_COLUMNS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_POINTER);
+	priv->filter = GTK_TREE_MODEL_FILTER (gtk_tree_model_filter_new (GTK_TREE_MODEL (priv->store), NULL));
+	gtk_tree_model_filter_set_visible_func (priv->filter, peer_visible_func, self, NULL);
 	column = gtk_tree_view_column_new_with_attributes (_("Public key"),
 	                                                   gtk_cell_renderer_text_new (),
 	                                                   "text", COL_PUBLIC_KEY,
@@ -272,33 +425,149 @@ wireguard_private_init (CEPageWireGuard *self)
 	gtk_tree_view_column_set_resizable (column, TRUE);
 	gtk_tree_view_append_column (priv->tree, column);
 
-	gtk_tree_view_set_model (priv->tree, GTK_TREE_MODEL (priv->store));
+	gtk_tree_view_set_model (priv->tree, GTK_TREE_MODEL (priv->filter));
+}
+
+static PeerRow *
+peers_table_add_row (CEPageWireGuard *self, NMWireGuardPeer *peer)
+{
+	CEPageWireGuardPrivate *priv = CE_PAGE_WIREGUARD_GET_PRIVATE (self);
+	PeerRow *row;
+
+	row = peer_row_new (peer);
+	g_hash_table_add (priv->rows, row);
+	index_add_row (priv->index, row);
+	if (priv->search_key && peer_row_matches (row, priv->search_key))
+		g_hash_table_add (priv->matched, row);
+	return row;
 }
 
 static void
-update_peers_table (CEPageWireGuard *self)
+peers_table_remove_row (CEPageWireGuard *self, PeerRow *row)
+{
+	CEPageWireGuardPrivate *priv = CE_PAGE_WIREGUARD_GET_PRIVATE (self);
+
+	index_remove_row (priv->index, row);
+	g_hash_table_remove (priv->matched, row);
+	g_hash_table_remove (priv->rows, row);
+}
+
+/* Appends rows for the peers of the setting from @first on */
+static void
+append_peers_table_rows (CEPageWireGuard *self, guint first)
 {
 	CEPageWireGuardPrivate *priv = CE_PAGE_WIREGUARD_GET_PRIVATE (self);
 	NMSettingWireGuard *setting = priv->setting;
 	guint i, num;
 
-	gtk_tree_store_clear (priv->store);
-
 	num = nm_setting_wireguard_get_peers_len (setting);
-	for (i = 0; i < num; i++) {
+	for (i = first; i < num; i++) {
 		NMWireGuardPeer *peer;
-		GtkTreeIter iter;
+		PeerRow *row;
+		char **token;
 		gs_free char *ips = NULL;
 
 		peer = nm_setting_wireguard_get_peer (setting, i);
 		ips = format_allowed_ips (peer);
-		gtk_tree_store_append (priv->store, &iter, NULL);
 
-		gtk_tree_store_set (priv->store, &iter,
-		                    COL_PUBLIC_KEY, nm_wireguard_peer_get_public_key (peer),
-		                    COL_ALLOWED_IPS, ips,
-		                    -1);
+		/* The index is sorted once all rows are in */
+		row = peer_row_new (peer);
+		g_hash_table_add (priv->rows, row);
+		for (token = row->tokens; *token; token++) {
+			PeerIndexEntry entry = { *token, row };
+
+			g_array_append_val (priv->index, entry);
+		}
+		if (priv->search_key && peer_row_matches (row, priv->search_key))
+			g_hash_table_add (priv->matched, row);
+
+		gtk_tree_store_insert_with_values (priv->store, NULL, NULL, -1,
+		                                   COL_PUBLIC_KEY, nm_wireguard_peer_get_public_key (peer),
+		                                   COL_ALLOWED_IPS, ips,
+		                                   COL_ROW, row,
+		                                   -1);
 	}
+	g_array_sort (priv->index, index_entry_cmp);
+}
+
+static void
+update_peers_table (CEPageWireGuard *self)
+{
+	CEPageWireGuardPrivate *priv = CE_PAGE_WIREGUARD_GET_PRIVATE (self);
+
+	gtk_tree_store_clear (priv->store);
+	g_array_set_size (priv->index, 0);
+	g_hash_table_remove_all (priv->matched);
+	g_hash_table_remove_all (priv->rows);
+
+	append_peers_table_rows (self, 0);
+}
+
+/* Updates the row of the peer at @idx of the setting.  If @append, the
+ * peer was just appended and gets a new row.
+ */
+static void
+update_peers_table_row (CEPageWireGuard *self, guint idx, gboolean append)
+{
+	CEPageWireGuardPrivate *priv = CE_PAGE_WIREGUARD_GET_PRIVATE (self);
+	NMWireGuardPeer *peer;
+	PeerRow *row = NULL;
+	GtkTreeIter iter;
+	gs_free char *ips = NULL;
+
+	peer = nm_setting_wireguard_get_peer (priv->setting, idx);
+	ips = format_allowed_ips (peer);
+
+	if (append) {
+		row = peers_table_add_row (self, peer);
+		gtk_tree_store_insert_with_values (priv->store, NULL, NULL, -1,
+		                                   COL_PUBLIC_KEY, nm_wireguard_peer_get_public_key (peer),
+		                                   COL_ALLOWED_IPS, ips,
+		                                   COL_ROW, row,
+		                                   -1);
+		return;
+	}
+
+	if (!gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (priv->store), &iter, NULL, idx))
+		g_return_if_reached ();
+
+	gtk_tree_model_get (GTK_TREE_MODEL (priv->store), &iter, COL_ROW, &row, -1);
+	if (row)
+		peers_table_remove_row (self, row);
+	row = peers_table_add_row (self, peer);
+
+	gtk_tree_store_set (priv->store, &iter,
+	                    COL_PUBLIC_KEY, nm_wireguard_peer_get_public_key (peer),
+	                    COL_ALLOWED_IPS, ips,
+	                    COL_ROW, row,
+	                    -1);
+}
+
+static void
+search_changed (GtkSearchEntry *entry, CEPageWireGuard *self)
+{
+	CEPageWireGuardPrivate *priv = CE_PAGE_WIREGUARD_GET_PRIVATE (self);
+	gs_free char *key = NULL;
+	guint pos;
+
+	key = g_ascii_strdown (gtk_entry_get_text (GTK_ENTRY (entry)), -1);
+	g_strstrip (key);
+
+	g_clear_pointer (&priv->search_key, g_free);
+	g_hash_table_remove_all (priv->matched);
+
+	if (key[0]) {
+		for (pos = index_lower_bound (priv->index, key); pos < priv->index->len; pos++) {
+			PeerIndexEntry *index_entry = &g_array_index (priv->index, PeerIndexEntry, pos);
+
+			if (!g_str_has_prefix (index_entry->token, key))
+				break;
+			g_hash_table_add (priv->matched, index_entry->row);
+		}
+		priv->search_key = g_steal_pointer (&key);
+	}
+
+	gtk_tree_model_filter_refilter (priv->filter);
 }
 
 static int
@@ -307,6 +576,7 @@ get_selected_index (CEPageWireGuard *self)
 	CEPageWireGuardPrivate *priv = CE_PAGE_WIREGUARD_GET_PRIVATE (self);
 	GtkTreeSelection *selection;
 	GtkTreeModel *model;
+	GtkTreePath *path;
 	GList *list;
 	int *indices;
 	int ret = -1;
@@ -318,11 +588,15 @@ get_selected_index (CEPageWireGuard *self)
 	if (!list)
 		goto done;
 
-	indices = gtk_tree_path_get_indices ((GtkTreePath *) list->data);
-	if (!indices)
+	/* Rows of the store are in the order of the peers of the setting */
+	path = gtk_tree_model_filter_convert_path_to_child_path (priv->filter, list->data);
+	if (!path)
 		goto done;
 
-	ret = indices[0];
+	indices = gtk_tree_path_get_indices (path);
+	if (indices)
+		ret = indices[0];
+	gtk_tree_path_free (path);
 done:
 	g_list_free_full (list, (GDestroyNotify) gtk_tree_path_free);
 	return ret;
@@ -385,16 +659,29 @@ peer_dialog_response_cb (GtkWidget *dialog, gint response, gpointer user_data)
 	CEPageWireGuardPrivate *priv = CE_PAGE_WIREGUARD_GET_PRIVATE (self);
 
 	if (response == GTK_RESPONSE_APPLY) {
+		guint len, idx;
+
 		peer_dialog_update_peer (dialog);
+		len = nm_setting_wireguard_get_peers_len (priv->setting);
 		if (priv->dialog_peer_index >= 0) {
+			idx = priv->dialog_peer_index;
 			nm_setting_wireguard_set_peer (priv->setting,
 			                               priv->dialog_peer,
-			                               priv->dialog_peer_index);
+			                               idx);
 		} else {
+			idx = len++;
 			nm_setting_wireguard_append_peer (priv->setting,
 			                                  priv->dialog_peer);
 		}
-		update_peers_table (self);
+
+		/* A peer with the same public key elsewhere in the list is
+		 * replaced by the setting, shifting the others; only rebuild
+		 * the table in that case. */
+		if (   nm_setting_wireguard_get_peers_len (priv->setting) == len
+		    && nm_setting_wireguard_get_peer (priv->setting, idx) == priv->dialog_peer)
+			update_peers_table_row (self, idx, priv->dialog_peer_index < 0);
+		else
+			update_peers_table (self);
 	}
 
 	nm_wireguard_peer_unref (priv->dialog_peer);
@@ -426,8 +713,16 @@ add_delete_clicked (GtkButton *button, CEPageWireGuard *self)
 	} else {
 		index = get_selected_index (self);
 		if (index >= 0) {
+			GtkTreeIter iter;
+			PeerRow *row = NULL;
+
 			nm_setting_wireguard_remove_peer (priv->setting, (guint) index);
-			update_peers_table (self);
+			if (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (priv->store), &iter, NULL, index)) {
+				gtk_tree_model_get (GTK_TREE_MODEL (priv->store), &iter, COL_ROW, &row, -1);
+				gtk_tree_store_remove (priv->store, &iter);
+				if (row)
+					peers_table_remove_row (self, row);
+			}
 		}
 	}
 }
@@ -460,6 +755,124 @@ row_activated (GtkTreeView       *tree_view,
 	gtk_widget_show (dialog);
 }
 
+/* Appends the [Peer] sections of @stream (wg-quick or `wg showconf`
+ * format) to the setting.  Peers replace existing ones with the same
+ * public key.
+ */
+static void
+import_peers (CEPageWireGuard *self, GInputStream *stream)
+{
+	CEPageWireGuardPrivate *priv = CE_PAGE_WIREGUARD_GET_PRIVATE (self);
+	gs_unref_ptrarray GPtrArray *peers = NULL;
+	gs_free_error GError *error = NULL;
+	nm_auto_free_gstring GString *errors = g_string_new (NULL);
+	GtkWidget *toplevel, *err_dialog;
+	gboolean replaced = FALSE;
+	guint n_errors;
+	guint i, first;
+
+	peers = utils_parse_wireguard_peers (stream, errors, &n_errors, &error);
+
+	/* Only notify once for the whole batch, so that the connection
+	 * changes (and its secrets get stored) in one go rather than once
+	 * per peer. */
+	first = nm_setting_wireguard_get_peers_len (priv->setting);
+	g_object_freeze_notify (G_OBJECT (priv->setting));
+	for (i = 0; i < peers->len; i++) {
+		NMWireGuardPeer *peer = peers->pdata[i];
+
+		if (   !replaced
+		    && nm_setting_wireguard_get_peer_by_public_key (priv->setting,
+		                                                    nm_wireguard_peer_get_public_key (peer),
+		                                                    NULL))
+			replaced = TRUE;
+		nm_setting_wireguard_append_peer (priv->setting, peer);
+	}
+	g_object_thaw_notify (G_OBJECT (priv->setting));
+
+	/* Detach the model so that the view isn't updated for each row */
+	gtk_tree_view_set_model (priv->tree, NULL);
+	if (replaced)
+		update_peers_table (self);
+	else
+		append_peers_table_rows (self, first);
+	gtk_tree_view_set_model (priv->tree, GTK_TREE_MODEL (priv->filter));
+	tree_selection_changed (self);
+
+	if (peers->len)
+		ce_page_changed (CE_PAGE (self));
+
+	if (error || n_errors) {
+		toplevel = gtk_widget_get_toplevel (CE_PAGE (self)->page);
+		err_dialog = gtk_message_dialog_new (GTK_WINDOW (toplevel),
+		                                     GTK_DIALOG_DESTROY_WITH_PARENT | GTK_DIALOG_MODAL,
+		                                     GTK_MESSAGE_WARNING,
+		                                     GTK_BUTTONS_CLOSE,
+		                                     ngettext ("Imported %u peer, but some could not be imported",
+		                                               "Imported %u peers, but some could not be imported",
+		                                               peers->len),
+		                                     peers->len);
+		gtk_message_dialog_format_secondary_text (GTK_MESSAGE_DIALOG (err_dialog), "%s",
+		                                          error ? error->message : errors->str);
+		gtk_dialog_run (GTK_DIALOG (err_dialog));
+		gtk_widget_destroy (err_dialog);
+	}
+}
+
+static void
+import_clicked (GtkButton *button, CEPageWireGuard *self)
+{
+	GtkWidget *toplevel, *chooser, *err_dialog;
+	GtkFileFilter *filter;
+	gs_free char *filename = NULL;
+	gs_unref_object GFile *file = NULL;
+	gs_unref_object GFileInputStream *stream = NULL;
+	gs_free_error GError *error = NULL;
+
+	toplevel = gtk_widget_get_toplevel (CE_PAGE (self)->page);
+	chooser = gtk_file_chooser_dialog_new (_("Select file to import"),
+	                                       GTK_WINDOW (toplevel),
+	                                       GTK_FILE_CHOOSER_ACTION_OPEN,
+	                                       _("_Cancel"), GTK_RESPONSE_CANCEL,
+	                                       _("_Open"), GTK_RESPONSE_ACCEPT,
+	                                       NULL);
+	gtk_window_set_modal (GTK_WINDOW (chooser), TRUE);
+
+	filter = gtk_file_filter_new ();
+	gtk_file_filter_set_name (filter, _("WireGuard configuration (*.conf)"));
+	gtk_file_filter_add_pattern (filter, "*.conf");
+	gtk_file_chooser_add_filter (GTK_FILE_CHOOSER (chooser), filter);
+	filter = gtk_file_filter_new ();
+	gtk_file_filter_set_name (filter, _("All files"));
+	gtk_file_filter_add_pattern (filter, "*");
+	gtk_file_chooser_add_filter (GTK_FILE_CHOOSER (chooser), filter);
+
+	if (gtk_dialog_run (GTK_DIALOG (chooser)) == GTK_RESPONSE_ACCEPT)
+		filename = gtk_file_chooser_get_filename (GTK_FILE_CHOOSER (chooser));
+	gtk_widget_destroy (chooser);
+
+	if (!filename)
+		return;
+
+	file = g_file_new_for_path (filename);
+	stream = g_file_read (file, NULL, &error);
+	if (!stream) {
+		err_dialog = gtk_message_dialog_new (GTK_WINDOW (toplevel),
+		                                     GTK_DIALOG_DESTROY_WITH_PARENT | GTK_DIALOG_MODAL,
+		                                     GTK_MESSAGE_ERROR,
+		                                     GTK_BUTTONS_CLOSE,
+		                                     _("Could not read peers from “%s”"),
+		                                     filename);
+		gtk_message_dialog_format_secondary_text (GTK_MESSAGE_DIALOG (err_dialog), "%s",
+		                                          error->message);
+		gtk_dialog_run (GTK_DIALOG (err_dialog));
+		gtk_widget_destroy (err_dialog);
+		return;
+	}
+
+	import_peers (self, G_INPUT_STREAM (stream));
+}
+
 static void
 show_private_key (GtkToggleButton *button, gpointer user_data)
 {
@@ -483,8 +896,10 @@ finish_setup (CEPageWireGuard *self, gpointer user_data)
 	g_signal_connect (priv->spin_listen_port,  "value-changed", G_CALLBACK (stuff_changed), self);
 	g_signal_connect (priv->button_add,        "clicked",       G_CALLBACK (add_delete_clicked), self);
 	g_signal_connect (priv->button_delete,     "clicked",       G_CALLBACK (add_delete_clicked), self);
+	g_signal_connect (priv->button_import,     "clicked",       G_CALLBACK (import_clicked), self);
 	g_signal_connect (priv->tree,              "row-activated", G_CALLBACK (row_activated), self);
 	g_signal_connect (priv->toggle_show_pk,    "toggled",       G_CALLBACK (show_private_key), self);
+	g_signal_connect (priv->entry_search,      "search-changed", G_CALLBACK (search_changed), self);
 
 	g_signal_connect_swapped (selection,       "changed",       G_CALLBACK (tree_selection_changed), self);
 }
@@ -599,6 +1014,26 @@ ce_page_wireguard_init (CEPageWireGuard *self)
 {
 }
 
+static void
+dispose (GObject *object)
+{
+	CEPageWireGuardPrivate *priv = CE_PAGE_WIREGUARD_GET_PRIVATE (object);
+
+	if (priv->tree) {
+		gtk_tree_view_set_model (priv->tree, NULL);
+		priv->tree = NULL;
+	}
+	g_clear_object (&priv->filter);
+	g_clear_object (&priv->store);
+
+	g_clear_pointer (&priv->index, g_array_unref);
+	g_clear_pointer (&priv->matched, g_hash_table_unref);
+	g_clear_pointer (&priv->rows, g_hash_table_unref);
+	g_clear_pointer (&priv->search_key, g_free);
+
+	G_OBJECT_CLASS (ce_page_wireguard_parent_class)->dispose (object);
+}
+
 static void
 ce_page_wireguard_class_init (CEPageWireGuardClass *wireguard_class)
 {
@@ -608,6 +1043,7 @@ ce_page_wireguard_class_init (CEPageWireGuardClass *wireguard_class)
 	g_type_class_add_private (object_class, sizeof (CEPageWireGuardPrivate));
 
 	parent_class->ce_page_validate_v = ce_page_validate_v;
+	object_class->dispose = dispose;
 }
 
 void
@@ -0,0 +1,737 @@
+// SPDX-License-Identifier: GPL-2.0+
+/* NetworkManager Connection editor -- Connection editor for NetworkManager
+ *
+ * Copyright 2026 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include <string.h>
+#include <arpa/inet.h>
+
+#include "utils.h"
+#include "ce-utils.h"
+
+#include "nm-utils/nm-test-utils.h"
+
+/*****************************************************************************/
+
+typedef struct {
+	GPtrArray *routes;
+	const char *reject;
+} ParseRoutesData;
+
+static gboolean
+parse_routes_cb (const char *dest,
+                 guint prefix,
+                 const char *next_hop,
+                 gint64 metric,
+                 gpointer user_data,
+                 GError **error)
+{
+	ParseRoutesData *data = user_data;
+
+	if (nm_streq0 (dest, data->reject)) {
+		g_set_error (error, NMA_ERROR, NMA_ERROR_GENERIC, "rejected %s", dest);
+		return FALSE;
+	}
+
+	g_ptr_array_add (data->routes,
+	                 g_strdup_printf ("%s/%u %s %" G_GINT64_FORMAT,
+	                                  dest, prefix, next_hop ?: "-", metric));
+	return TRUE;
+}
+
+static GPtrArray *
+parse_routes (const char *text,
+              int family,
+              const char *reject,
+              GString *errors,
+              guint *out_n_errors)
+{
+	gs_unref_object GInputStream *stream = NULL;
+	ParseRoutesData data = { .reject = reject };
+	GError *error = NULL;
+	gboolean success;
+
+	data.routes = g_ptr_array_new_with_free_func (g_free);
+	stream = g_memory_input_stream_new_from_data (text, -1, NULL);
+	success = utils_parse_routes (stream, family, parse_routes_cb, &data,
+	                              errors, out_n_errors, &error);
+	g_assert_no_error (error);
+	g_assert (success);
+
+	return data.routes;
+}
+
+static void
+assert_routes (GPtrArray *routes, const char *const *expected)
+{
+	guint i;
+
+	for (i = 0; expected[i]; i++) {
+		g_assert_cmpuint (i, <, routes->len);
+		g_assert_cmpstr (routes->pdata[i], ==, expected[i]);
+	}
+	g_assert_cmpuint (i, ==, routes->len);
+}
+
+static void
+test_parse_routes_ip4 (void)
+{
+	static const char *const expected[] = {
+		"10.0.0.0/8 192.168.1.1 100",
+		"0.0.0.0/0 192.168.1.254 -1",
+		"192.168.5.1/32 - -1",
+		"172.16.0.0/12 10.0.0.1 -1",
+		"1.2.3.0/24 10.0.0.2 20",
+		NULL,
+	};
+	gs_unref_ptrarray GPtrArray *routes = NULL;
+	nm_auto_free_gstring GString *errors = g_string_new (NULL);
+	guint n_errors;
+
+	routes = parse_routes ("10.0.0.0/8 via 192.168.1.1 dev eth0 proto static metric 100\n"
+	                       "default via 192.168.1.254\n"
+	                       "\n"
+	                       "   \t \n"
+	                       "# a comment\n"
+	                       "192.168.5.1 dev eth1 scope link\n"
+	                       "172.16.0.0/12 via 10.0.0.1 # a trailing comment\r\n"
+	                       "unicast 1.2.3.0/24 via inet 10.0.0.2 onlink preference 20",
+	                       AF_INET, NULL, errors, &n_errors);
+
+	assert_routes (routes, expected);
+	g_assert_cmpuint (n_errors, ==, 0);
+	g_assert_cmpstr (errors->str, ==, "");
+}
+
+static void
+test_parse_routes_ip6 (void)
+{
+	static const char *const expected[] = {
+		"2001:db8::/32 fe80::1 1024",
+		"::/0 fe80::2 -1",
+		"fd00::1/128 - -1",
+		NULL,
+	};
+	gs_unref_ptrarray GPtrArray *routes = NULL;
+	nm_auto_free_gstring GString *errors = g_string_new (NULL);
+	guint n_errors;
+
+	routes = parse_routes ("2001:db8::/32 via fe80::1 dev eth0 metric 1024 pref medium\n"
+	                       "default via inet6 fe80::2\n"
+	                       "fd00::1\n"
+	                       "10.0.0.0/8\n"
+	                       "2001:db8::/129\n"
+	                       "2001:db8::/64 via 10.0.0.1\n",
+	                       AF_INET6, NULL, errors, &n_errors);
+
+	assert_routes (routes, expected);
+	g_assert_cmpuint (n_errors, ==, 3);
+	g_assert (strstr (errors->str, "Line 4: "));
+	g_assert (strstr (errors->str, "Line 5: "));
+	g_assert (strstr (errors->str, "Line 6: "));
+}
+
+static void
+test_parse_routes_errors (void)
+{
+	static const char *const expected[] = {
+		"10.1.0.0/16 - -1",
+		"10.3.0.0/16 - 5",
+		NULL,
+	};
+	gs_unref_ptrarray GPtrArray *routes = NULL;
+	nm_auto_free_gstring GString *errors = g_string_new (NULL);
+	guint n_errors;
+
+	routes = parse_routes ("blackhole 10.0.0.0/8\n"
+	                       "10.1.0.0/16\n"
+	                       "10.0.0.0/33\n"
+	                       "not-an-address\n"
+	                       "10.0.0.0/8 via\n"
+	                       "10.0.0.0/8 bogus 1\n"
+	                       "10.0.0.0/8 metric -5\n"
+	                       "10.2.0.0/16 via 10.0.0.1\n"
+	                       "10.3.0.0/16 metric 5\n"
+	                       "unicast\n",
+	                       AF_INET, "10.2.0.0", errors, &n_errors);
+
+	assert_routes (routes, expected);
+	g_assert_cmpuint (n_errors, ==, 8);
+
+	/* Each failed line is reported with its number; the good ones aren't */
+	g_assert (strstr (errors->str, "Line 1: "));
+	g_assert (!strstr (errors->str, "Line 2: "));
+	g_assert (strstr (errors->str, "Line 3: "));
+	g_assert (strstr (errors->str, "Line 4: "));
+	g_assert (strstr (errors->str, "Line 5: "));
+	g_assert (strstr (errors->str, "Line 6: "));
+	g_assert (strstr (errors->str, "Line 7: "));
+	g_assert (strstr (errors->str, "Line 8: rejected 10.2.0.0\n"));
+	g_assert (!strstr (errors->str, "Line 9: "));
+	g_assert (strstr (errors->str, "Line 10: "));
+}
+
+static void
+test_parse_routes_many_errors (void)
+{
+	gs_unref_ptrarray GPtrArray *routes = NULL;
+	nm_auto_free_gstring GString *text = g_string_new (NULL);
+	nm_auto_free_gstring GString *errors = g_string_new (NULL);
+	guint n_errors;
+	guint i;
+
+	for (i = 0; i < 25; i++)
+		g_string_append (text, "garbage\n");
+
+	routes = parse_routes (text->str, AF_INET, NULL, errors, &n_errors);
+
+	g_assert_cmpuint (routes->len, ==, 0);
+	g_assert_cmpuint (n_errors, ==, 25);
+	g_assert (strstr (errors->str, "Line 20: "));
+	g_assert (!strstr (errors->str, "Line 21: "));
+	g_assert (g_str_has_suffix (errors->str, "…and 5 more errors\n"));
+}
+
+#define PARSE_ROUTES_PERF_LINES 10000
+
+static void
+test_parse_routes_perf (void)
+{
+	gs_unref_ptrarray GPtrArray *routes = NULL;
+	nm_auto_free_gstring GString *text = g_string_new (NULL);
+	guint n_errors;
+	double elapsed;
+	guint i;
+
+	for (i = 0; i < PARSE_ROUTES_PERF_LINES; i++) {
+		g_string_append_printf (text, "10.%u.%u.0/24 via 192.168.%u.1 dev eth0 proto static metric %u\n",
+		                        i / 256, i % 256, i % 256, i);
+	}
+
+	g_test_timer_start ();
+	routes = parse_routes (text->str, AF_INET, NULL, NULL, &n_errors);
+	elapsed = g_test_timer_elapsed ();
+
+	g_assert_cmpuint (routes->len, ==, PARSE_ROUTES_PERF_LINES);
+	g_assert_cmpuint (n_errors, ==, 0);
+
+	g_test_minimized_result (elapsed, "parsing %u routes: %.1f ms",
+	                         PARSE_ROUTES_PERF_LINES, elapsed * 1000);
+}
+
+/*****************************************************************************/
+
+/* Like in the connection list, the model rows point to their sort keys */
+
+#define SORT_COL_KEYS      0
+#define SORT_COL_ID        1
+#define SORT_COL_TIMESTAMP 2
+
+#define SORT_PERF_ROWS 10000
+
+static gint
+sort_id_func (GtkTreeModel *model, GtkTreeIter *a, GtkTreeIter *b, gpointer user_data)
+{
+	UtilsSortKeys *keys_a, *keys_b;
+
+	gtk_tree_model_get (model, a, SORT_COL_KEYS, &keys_a, -1);
+	gtk_tree_model_get (model, b, SORT_COL_KEYS, &keys_b, -1);
+	return utils_sort_keys_cmp_id (keys_a, keys_b);
+}
+
+static gint
+sort_timestamp_func (GtkTreeModel *model, GtkTreeIter *a, GtkTreeIter *b, gpointer user_data)
+{
+	UtilsSortKeys *keys_a, *keys_b;
+
+	gtk_tree_model_get (model, a, SORT_COL_KEYS, &keys_a, -1);
+	gtk_tree_model_get (model, b, SORT_COL_KEYS, &keys_b, -1);
+	return utils_sort_keys_cmp_timestamp (keys_a, keys_b);
+}
+
+static void
+sort_keys_free (UtilsSortKeys *keys)
+{
+	utils_sort_keys_clear (keys);
+	g_slice_free (UtilsSortKeys, keys);
+}
+
+static GPtrArray *
+sort_keys_new (const char *const *ids, const guint64 *timestamps, guint n)
+{
+	GPtrArray *array;
+	guint i;
+
+	array = g_ptr_array_new_with_free_func ((GDestroyNotify) sort_keys_free);
+	for (i = 0; i < n; i++) {
+		UtilsSortKeys *keys = g_slice_new0 (UtilsSortKeys);
+
+		utils_sort_keys_set (keys, ids ? ids[i] : "connection", timestamps ? timestamps[i] : 0);
+		g_ptr_array_add (array, keys);
+	}
+	return array;
+}
+
+static GtkTreeModel *
+sort_model_new (GPtrArray *array, const char *const *ids)
+{
+	gs_unref_object GtkTreeStore *store = NULL;
+	GtkTreeModel *sorted;
+	guint i;
+
+	store = gtk_tree_store_new (3, G_TYPE_POINTER, G_TYPE_STRING, G_TYPE_UINT64);
+	for (i = 0; i < array->len; i++) {
+		UtilsSortKeys *keys = array->pdata[i];
+
+		gtk_tree_store_insert_with_values (store, NULL, NULL, -1,
+		                                   SORT_COL_KEYS, keys,
+		                                   SORT_COL_ID, ids ? ids[i] : NULL,
+		                                   SORT_COL_TIMESTAMP, keys->timestamp,
+		                                   -1);
+	}
+
+	sorted = gtk_tree_model_sort_new_with_model (GTK_TREE_MODEL (store));
+	gtk_tree_sortable_set_sort_func (GTK_TREE_SORTABLE (sorted), SORT_COL_ID,
+	                                 sort_id_func, NULL, NULL);
+	gtk_tree_sortable_set_sort_func (GTK_TREE_SORTABLE (sorted), SORT_COL_TIMESTAMP,
+	                                 sort_timestamp_func, NULL, NULL);
+	return sorted;
+}
+
+static guint
+sort_model_check (GtkTreeModel *model, int column)
+{
+	UtilsSortKeys *prev = NULL, *keys;
+	GtkTreeIter iter;
+	gboolean valid;
+	guint n = 0;
+
+	for (valid = gtk_tree_model_get_iter_first (model, &iter);
+	     valid;
+	     valid = gtk_tree_model_iter_next (model, &iter)) {
+		gtk_tree_model_get (model, &iter, SORT_COL_KEYS, &keys, -1);
+		if (prev) {
+			if (column == SORT_COL_ID)
+				g_assert_cmpint (utils_sort_keys_cmp_id (prev, keys), <=, 0);
+			else
+				g_assert_cmpint (utils_sort_keys_cmp_timestamp (prev, keys), <=, 0);
+		}
+		prev = keys;
+		n++;
+	}
+	return n;
+}
+
+static void
+test_sort_id (void)
+{
+	static const char *const ids[] = {
+		"Wired connection 2", "wired connection 1", "Ärger", "zebra", "Zebra",
+		"VPN 10", "VPN 9", "Hotspot", "eth0", "Éclair", "", "abc",
+	};
+	gs_unref_ptrarray GPtrArray *array = NULL;
+	gs_unref_object GtkTreeModel *sorted = NULL;
+	GtkTreeIter iter;
+	gboolean valid;
+	char *prev = NULL, *id;
+	guint i, j;
+
+	array = sort_keys_new (ids, NULL, G_N_ELEMENTS (ids));
+
+	/* The keys compare like the names do in the current locale */
+	for (i = 0; i < array->len; i++) {
+		for (j = 0; j < array->len; j++) {
+			int by_key = utils_sort_keys_cmp_id (array->pdata[i], array->pdata[j]);
+			int by_name = g_utf8_collate (ids[i], ids[j]);
+
+			g_assert_cmpint ((by_key > 0) - (by_key < 0), ==, (by_name > 0) - (by_name < 0));
+		}
+	}
+
+	sorted = sort_model_new (array, ids);
+	gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (sorted), SORT_COL_ID, GTK_SORT_ASCENDING);
+	g_assert_cmpuint (sort_model_check (sorted, SORT_COL_ID), ==, G_N_ELEMENTS (ids));
+
+	for (valid = gtk_tree_model_get_iter_first (sorted, &iter);
+	     valid;
+	     valid = gtk_tree_model_iter_next (sorted, &iter)) {
+		gtk_tree_model_get (sorted, &iter, SORT_COL_ID, &id, -1);
+		if (prev)
+			g_assert_cmpint (g_utf8_collate (prev, id), <=, 0);
+		g_free (prev);
+		prev = id;
+	}
+	g_free (prev);
+}
+
+static void
+test_sort_timestamp (void)
+{
+	/* Differences that don't fit an int */
+	static const guint64 timestamps[] = {
+		0,
+		G_GUINT64_CONSTANT (1) << 32,
+		1,
+		G_GUINT64_CONSTANT (1) << 40,
+		(guint64) G_MAXUINT32 + 5,
+		100,
+		G_MAXUINT64,
+	};
+	gs_unref_ptrarray GPtrArray *array = NULL;
+	gs_unref_object GtkTreeModel *sorted = NULL;
+	GtkTreeIter iter;
+	guint64 prev = G_MAXUINT64, timestamp;
+	gboolean valid;
+	guint n = 0;
+
+	array = sort_keys_new (NULL, timestamps, G_N_ELEMENTS (timestamps));
+	sorted = sort_model_new (array, NULL);
+	gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (sorted), SORT_COL_TIMESTAMP, GTK_SORT_ASCENDING);
+
+	/* The most recently used first, the never used last */
+	for (valid = gtk_tree_model_get_iter_first (sorted, &iter);
+	     valid;
+	     valid = gtk_tree_model_iter_next (sorted, &iter)) {
+		gtk_tree_model_get (sorted, &iter, SORT_COL_TIMESTAMP, &timestamp, -1);
+		if (n++)
+			g_assert_cmpuint (prev, >, timestamp);
+		prev = timestamp;
+	}
+	g_assert_cmpuint (n, ==, G_N_ELEMENTS (timestamps));
+	g_assert_cmpuint (prev, ==, 0);
+}
+
+static void
+test_sort_perf (void)
+{
+	gs_unref_ptrarray GPtrArray *array = NULL;
+	gs_unref_object GtkTreeModel *sorted = NULL;
+	gs_strfreev char **ids = NULL;
+	guint64 *timestamps;
+	GRand *rand;
+	double elapsed;
+	guint i;
+
+	rand = g_rand_new_with_seed (SORT_PERF_ROWS);
+	ids = g_new0 (char *, SORT_PERF_ROWS + 1);
+	timestamps = g_new (guint64, SORT_PERF_ROWS);
+	for (i = 0; i < SORT_PERF_ROWS; i++) {
+		ids[i] = g_strdup_printf ("Connection %08x", g_rand_int (rand));
+		timestamps[i] = g_rand_int (rand);
+	}
+	g_rand_free (rand);
+
+	array = sort_keys_new ((const char *const *) ids, timestamps, SORT_PERF_ROWS);
+	g_free (timestamps);
+	sorted = sort_model_new (array, (const char *const *) ids);
+
+	g_test_timer_start ();
+	for (i = 0; i < 4; i++) {
+		int column = i % 2 ? SORT_COL_TIMESTAMP : SORT_COL_ID;
+
+		gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (sorted), column,
+		                                      i < 2 ? GTK_SORT_ASCENDING : GTK_SORT_DESCENDING);
+		g_assert_cmpuint (gtk_tree_model_iter_n_children (sorted, NULL), ==, SORT_PERF_ROWS);
+	}
+	elapsed = g_test_timer_elapsed ();
+
+	g_test_minimized_result (elapsed / 4, "sorting %u rows: %.1f ms",
+	                         SORT_PERF_ROWS, elapsed / 4 * 1000);
+}
+
+/*****************************************************************************/
+
+#define KEY_A "xTIBA5rboUvnH4htodjb6e697QjLERt1NAB4mZqp8Dg="
+#define KEY_B "TrMvSoP4jYQlY6RIzBgbssQqY3vxI2Pi+y71lOWWXX0="
+#define KEY_C "HIgo9xNzJMWLKASShiTqIybxZ0U3wGLiUeJ1PKf8ykw="
+#define PSK   "/UwcSPg38hW/D9Y3tcS1FOV0K1wuURMbS0sesJEP5ak="
+
+static GPtrArray *
+parse_peers (const char *text, GString *errors, guint *out_n_errors)
+{
+	gs_unref_object GInputStream *stream = NULL;
+	GError *error = NULL;
+	GPtrArray *peers;
+
+	stream = g_memory_input_stream_new_from_data (text, -1, NULL);
+	peers = utils_parse_wireguard_peers (stream, errors, out_n_errors, &error);
+	g_assert_no_error (error);
+	g_assert (peers);
+
+	return peers;
+}
+
+static void
+test_wireguard_peers (void)
+{
+	gs_unref_ptrarray GPtrArray *peers = NULL;
+	nm_auto_free_gstring GString *errors = g_string_new (NULL);
+	NMWireGuardPeer *peer;
+	guint n_errors;
+
+	peers = parse_peers ("# wg-quick configuration\n"
+	                     "[Interface]\n"
+	                     "PrivateKey = " KEY_C "\n"
+	                     "Address = 10.0.0.2/24\n"
+	                     "\n"
+	                     "[Peer]\n"
+	                     "PublicKey = " KEY_A "   # the server\n"
+	                     "PresharedKey=" PSK "\n"
+	                     "AllowedIPs = 10.0.0.0/24, fd00::/64,\n"
+	                     "Endpoint = 192.0.2.1:51820\r\n"
+	                     "  persistentkeepalive = 25\n"
+	                     "\n"
+	                     "[peer]\n"
+	                     "PublicKey = " KEY_B "\n"
+	                     "PersistentKeepalive = off\n",
+	                     errors, &n_errors);
+
+	g_assert_cmpuint (n_errors, ==, 0);
+	g_assert_cmpstr (errors->str, ==, "");
+	g_assert_cmpuint (peers->len, ==, 2);
+
+	peer = peers->pdata[0];
+	g_assert (nm_wireguard_peer_is_sealed (peer));
+	g_assert_cmpstr (nm_wireguard_peer_get_public_key (peer), ==, KEY_A);
+	g_assert_cmpstr (nm_wireguard_peer_get_preshared_key (peer), ==, PSK);
+	g_assert_cmpint (nm_wireguard_peer_get_preshared_key_flags (peer), ==, NM_SETTING_SECRET_FLAG_NONE);
+	g_assert_cmpuint (nm_wireguard_peer_get_allowed_ips_len (peer), ==, 2);
+	g_assert_cmpstr (nm_wireguard_peer_get_allowed_ip (peer, 0, NULL), ==, "10.0.0.0/24");
+	g_assert_cmpstr (nm_wireguard_peer_get_allowed_ip (peer, 1, NULL), ==, "fd00::/64");
+	g_assert_cmpstr (nm_wireguard_peer_get_endpoint (peer), ==, "192.0.2.1:51820");
+	g_assert_cmpuint (nm_wireguard_peer_get_persistent_keepalive (peer), ==, 25);
+
+	peer = peers->pdata[1];
+	g_assert_cmpstr (nm_wireguard_peer_get_public_key (peer), ==, KEY_B);
+	g_assert_cmpstr (nm_wireguard_peer_get_preshared_key (peer), ==, NULL);
+	g_assert_cmpuint (nm_wireguard_peer_get_allowed_ips_len (peer), ==, 0);
+	g_assert_cmpuint (nm_wireguard_peer_get_persistent_keepalive (peer), ==, 0);
+}
+
+static void
+test_wireguard_peers_errors (void)
+{
+	gs_unref_ptrarray GPtrArray *peers = NULL;
+	nm_auto_free_gstring GString *errors = g_string_new (NULL);
+	guint n_errors;
+
+	peers = parse_peers ("[Peer]\n"                                /* 1 */
+	                     "PublicKey = " KEY_A "\n"
+	                     "Foo = bar\n"                             /* 3: unknown key */
+	                     "[Peer]\n"
+	                     "PublicKey = bm90IGEga2V5\n"              /* 5: not 32 bytes */
+	                     "[Peer]\n"
+	                     "PublicKey = " KEY_B "\n"
+	                     "PresharedKey = !!not-base64!!\n"         /* 8 */
+	                     "[Peer]\n"
+	                     "PublicKey = " KEY_C "\n"
+	                     "PersistentKeepalive = 70000\n"           /* 11 */
+	                     "[Peer]\n"
+	                     "PublicKey\n"                             /* 13: no value */
+	                     "[Peer]\n"                                /* 14: no public key */
+	                     "AllowedIPs = 10.0.0.0/8\n"
+	                     "[Peer]\n"
+	                     "PublicKey = " KEY_C "\n"
+	                     "AllowedIPs = 10.0.0.0/33\n"              /* 18 */
+	                     "[Peer]\n"
+	                     "PublicKey = " KEY_B "\n"
+	                     "PersistentKeepalive = 0\n",
+	                     errors, &n_errors);
+
+	/* Only the last peer is fine */
+	g_assert_cmpuint (peers->len, ==, 1);
+	g_assert_cmpstr (nm_wireguard_peer_get_public_key (peers->pdata[0]), ==, KEY_B);
+
+	g_assert_cmpuint (n_errors, ==, 7);
+	g_assert (strstr (errors->str, "Line 3: "));
+	g_assert (strstr (errors->str, "Foo"));
+	g_assert (strstr (errors->str, "Line 5: "));
+	g_assert (strstr (errors->str, "Line 8: "));
+	g_assert (strstr (errors->str, "Line 11: "));
+	g_assert (strstr (errors->str, "Line 13: "));
+	g_assert (strstr (errors->str, "Line 14: "));
+	g_assert (strstr (errors->str, "Line 18: "));
+	g_assert (!strstr (errors->str, "Line 1: "));
+
+	/* Values are not repeated, they may be secrets */
+	g_assert (!strstr (errors->str, "not-base64"));
+	g_assert (!strstr (errors->str, "bm90IGEga2V5"));
+}
+
+static void
+test_wireguard_peers_duplicates (void)
+{
+	gs_unref_ptrarray GPtrArray *peers = NULL;
+	gs_unref_object NMSettingWireGuard *s_wg = NULL;
+	NMWireGuardPeer *peer;
+	guint n_errors;
+	guint i;
+
+	peers = parse_peers ("[Peer]\n"
+	                     "PublicKey = " KEY_A "\n"
+	                     "AllowedIPs = 10.0.0.0/24\n"
+	                     "AllowedIPs = 10.1.0.0/24\n"
+	                     "Endpoint = 192.0.2.1:1\n"
+	                     "Endpoint = 192.0.2.2:2\n"
+	                     "[Peer]\n"
+	                     "PublicKey = " KEY_B "\n"
+	                     "[Peer]\n"
+	                     "PublicKey = " KEY_A "\n"
+	                     "Endpoint = 192.0.2.3:3\n",
+	                     NULL, &n_errors);
+
+	g_assert_cmpuint (n_errors, ==, 0);
+	g_assert_cmpuint (peers->len, ==, 3);
+
+	/* Within a section, AllowedIPs add up and other keys override */
+	peer = peers->pdata[0];
+	g_assert_cmpuint (nm_wireguard_peer_get_allowed_ips_len (peer), ==, 2);
+	g_assert_cmpstr (nm_wireguard_peer_get_endpoint (peer), ==, "192.0.2.2:2");
+
+	/* A later peer with the same key replaces the earlier one once added */
+	s_wg = NM_SETTING_WIREGUARD (nm_setting_wireguard_new ());
+	for (i = 0; i < peers->len; i++)
+		nm_setting_wireguard_append_peer (s_wg, peers->pdata[i]);
+	g_assert_cmpuint (nm_setting_wireguard_get_peers_len (s_wg), ==, 2);
+	peer = nm_setting_wireguard_get_peer_by_public_key (s_wg, KEY_A, NULL);
+	g_assert (peer);
+	g_assert_cmpstr (nm_wireguard_peer_get_endpoint (peer), ==, "192.0.2.3:3");
+	g_assert_cmpuint (nm_wireguard_peer_get_allowed_ips_len (peer), ==, 0);
+}
+
+/*****************************************************************************/
+
+static GPtrArray *
+connections_new (const char *const *ids)
+{
+	GPtrArray *connections;
+
+	connections = g_ptr_array_new_with_free_func (g_object_unref);
+	for (; *ids; ids++) {
+		NMConnection *connection = nm_simple_connection_new ();
+		NMSetting *s_con = nm_setting_connection_new ();
+
+		g_object_set (s_con, NM_SETTING_CONNECTION_ID, *ids, NULL);
+		nm_connection_add_setting (connection, s_con);
+		g_ptr_array_add (connections, connection);
+	}
+	return connections;
+}
+
+static void
+assert_next_name (const char *const *ids, const char *format, const char *expected)
+{
+	gs_unref_ptrarray GPtrArray *connections = connections_new (ids);
+	gs_free char *name = NULL;
+
+	name = utils_next_available_name (connections, format);
+	g_assert_cmpstr (name, ==, expected);
+}
+
+static void
+test_next_name_formats (void)
+{
+	static const char *const none[] = { NULL };
+	static const char *const prefixed[] = {
+		"VPN connection 1", "VPN connection 2", "Wired connection 3", NULL,
+	};
+	static const char *const suffixed[] = {
+		"1. Ethernet", "2. Ethernet", "Ethernet", NULL,
+	};
+	static const char *const percent[] = {
+		"1% VPN", "2% VPN", NULL,
+	};
+
+	assert_next_name (none, "VPN connection %d", "VPN connection 1");
+	assert_next_name (prefixed, "VPN connection %d", "VPN connection 3");
+	assert_next_name (prefixed, "Wired connection %d", "Wired connection 1");
+	assert_next_name (suffixed, "%d. Ethernet", "3. Ethernet");
+	assert_next_name (suffixed, "Ethernet %d", "Ethernet 1");
+
+	/* Formats that can't be taken apart go through the fallback */
+	assert_next_name (prefixed, "VPN connection %1$d", "VPN connection 3");
+	assert_next_name (percent, "%d%% VPN", "3% VPN");
+	assert_next_name (percent, "VPN", "VPN");
+}
+
+static void
+test_next_name_numbers (void)
+{
+	static const char *const padded[] = {
+		"VPN connection 01", "VPN connection 002", "VPN connection +1", "VPN connection -1",
+		"VPN connection 1 ", "vpn connection 1", "VPN connection 1a", "VPN connection ",
+		NULL,
+	};
+	static const char *const gaps[] = {
+		"VPN connection 4", "VPN connection 1", "VPN connection 2", "VPN connection 7",
+		"VPN connection 2", NULL,
+	};
+	static const char *const large[] = {
+		"VPN connection 1", "VPN connection 10000", "VPN connection 99999",
+		"VPN connection 4294967297", "VPN connection 2", NULL,
+	};
+
+	/* None of these is what "%d" gives for 1 */
+	assert_next_name (padded, "VPN connection %d", "VPN connection 1");
+	assert_next_name (padded, "VPN connection %1$d", "VPN connection 1");
+
+	/* The first gap is taken; duplicates don't matter */
+	assert_next_name (gaps, "VPN connection %d", "VPN connection 3");
+	assert_next_name (gaps, "VPN connection %1$d", "VPN connection 3");
+
+	/* 5 digit numbers and more are beyond the range and ignored */
+	assert_next_name (large, "VPN connection %d", "VPN connection 3");
+	assert_next_name (large, "VPN connection %1$d", "VPN connection 3");
+}
+
+static void
+test_next_name_full (void)
+{
+	gs_unref_ptrarray GPtrArray *ids = NULL;
+	guint i;
+
+	ids = g_ptr_array_new_with_free_func (g_free);
+	for (i = 1; i < 10000; i++)
+		g_ptr_array_add (ids, g_strdup_printf ("VPN connection %u", i));
+	g_ptr_array_add (ids, NULL);
+
+	assert_next_name ((const char *const *) ids->pdata, "VPN connection %d", NULL);
+
+	/* Free up one in the middle */
+	g_free (ids->pdata[4999]);
+	ids->pdata[4999] = g_strdup ("VPN connection 05000");
+	assert_next_name ((const char *const *) ids->pdata, "VPN connection %d", "VPN connection 5000");
+	assert_next_name ((const char *const *) ids->pdata, "VPN connection %1$d", "VPN connection 5000");
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	nmtst_init (&argc, &argv, TRUE);
+
+	g_test_add_func ("/ce_utils/parse_routes/ip4", test_parse_routes_ip4);
+	g_test_add_func ("/ce_utils/parse_routes/ip6", test_parse_routes_ip6);
+	g_test_add_func ("/ce_utils/parse_routes/errors", test_parse_routes_errors);
+	g_test_add_func ("/ce_utils/parse_routes/many_errors", test_parse_routes_many_errors);
+	g_test_add_func ("/ce_utils/wireguard_peers/parse", test_wireguard_peers);
+	g_test_add_func ("/ce_utils/wireguard_peers/errors", test_wireguard_peers_errors);
+	g_test_add_func ("/ce_utils/wireguard_peers/duplicates", test_wireguard_peers_duplicates);
+	g_test_add_func ("/ce_utils/next_name/formats", test_next_name_formats);
+	g_test_add_func ("/ce_utils/next_name/numbers", test_next_name_numbers);
+	g_test_add_func ("/ce_utils/next_name/full", test_next_name_full);
+	g_test_add_func ("/ce_utils/sort/id", test_sort_id);
+	g_test_add_func ("/ce_utils/sort/timestamp", test_sort_timestamp);
+	if (g_test_perf ()) {
+		g_test_add_func ("/ce_utils/parse_routes/perf", test_parse_routes_perf);
+		g_test_add_func ("/ce_utils/sort/perf", test_sort_perf);
+	}
+
+	return g_test_run ();
+}
@@ -0,0 +1,52 @@
+#!/bin/sh
+# SPDX-License-Identifier: GPL-2.0+
+#
+# Checks that nm-connection-editor --import-dir exits with a failure
+# status when some of the files could not be imported.
+#
+# Usage: test-import-dir.sh [path/to/nm-connection-editor]
+
+editor="${1:-src/connection-editor/nm-connection-editor}"
+
+if [ -z "$DISPLAY" ] && [ -z "$WAYLAND_DISPLAY" ]; then
+	echo "SKIP: no display"
+	exit 77
+fi
+
+dir="$(mktemp -d)" || exit 1
+trap 'rm -rf "$dir"' EXIT
+
+run () {
+	out="$("$editor" --import-dir "$dir" 2>&1)"
+	status=$?
+	case "$out" in
+	*"Failed to connect to NetworkManager"*)
+		echo "SKIP: NetworkManager is not running"
+		exit 77
+		;;
+	esac
+}
+
+# Nothing to import
+run
+if [ "$status" != 0 ]; then
+	echo "FAIL: empty directory exited with $status: $out"
+	exit 1
+fi
+
+# A file no importer understands
+echo "this is not a connection" > "$dir/garbage.conf"
+run
+if [ "$status" != 1 ]; then
+	echo "FAIL: failed import exited with $status: $out"
+	exit 1
+fi
+case "$out" in
+*"1 failed"*) ;;
+*)
+	echo "FAIL: unexpected summary: $out"
+	exit 1
+	;;
+esac
+
+exit 0
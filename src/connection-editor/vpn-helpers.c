@@ -14,6 +14,48 @@
 #include "vpn-helpers.h"
 #include "utils.h"
 
+#define PLUGIN_LOAD_FAILED_TAG "nm-ce-vpn-plugin-load-failed"
+
+static GThread *plugin_infos_thread = NULL;
+
+NMVpnEditorPlugin *
+vpn_get_editor_plugin (NMVpnPluginInfo *plugin_info)
+{
+	NMVpnEditorPlugin *plugin;
+	GError *error = NULL;
+
+	plugin = nm_vpn_plugin_info_get_editor_plugin (plugin_info);
+	if (plugin)
+		return plugin;
+
+	/* Only try (and complain) once per plugin */
+	if (g_object_get_data (G_OBJECT (plugin_info), PLUGIN_LOAD_FAILED_TAG))
+		return NULL;
+
+	plugin = nm_vpn_plugin_info_load_editor_plugin (plugin_info, &error);
+	if (plugin) {
+		g_info ("vpn: (%s,%s) loaded",
+		        nm_vpn_plugin_info_get_name (plugin_info),
+		        nm_vpn_plugin_info_get_filename (plugin_info));
+		return plugin;
+	}
+
+	if (   !nm_vpn_plugin_info_get_plugin (plugin_info)
+	    && nm_vpn_plugin_info_lookup_property (plugin_info, NM_VPN_PLUGIN_INFO_KF_GROUP_GNOME, "properties")) {
+		g_message ("vpn: (%s,%s) cannot load legacy-only plugin",
+		           nm_vpn_plugin_info_get_name (plugin_info),
+		           nm_vpn_plugin_info_get_filename (plugin_info));
+	} else {
+		g_warning ("vpn: (%s,%s) could not load plugin: %s",
+		           nm_vpn_plugin_info_get_name (plugin_info),
+		           nm_vpn_plugin_info_get_filename (plugin_info),
+		           error->message);
+	}
+	g_clear_error (&error);
+	g_object_set_data (G_OBJECT (plugin_info), PLUGIN_LOAD_FAILED_TAG, GUINT_TO_POINTER (TRUE));
+	return NULL;
+}
+
 NMVpnEditorPlugin *
 vpn_get_plugin_by_service (const char *service)
 {
@@ -21,7 +63,7 @@ vpn_get_plugin_by_service (const char *service)
 
 	plugin_info = nm_vpn_plugin_info_list_find_by_service (vpn_get_plugin_infos (), service);
 	if (plugin_info)
-		return nm_vpn_plugin_info_get_editor_plugin (plugin_info);
+		return vpn_get_editor_plugin (plugin_info);
 	return NULL;
 }
 
@@ -31,50 +73,61 @@ _sort_vpn_plugins (NMVpnPluginInfo *aa, NMVpnPluginInfo *bb)
 	return strcmp (nm_vpn_plugin_info_get_name (aa), nm_vpn_plugin_info_get_name (bb));
 }
 
+static gpointer
+load_plugin_infos (gpointer user_data)
+{
+	GSList *plugins, *iter;
+
+	plugins = nm_vpn_plugin_info_list_load ();
+
+	/* Load the editor plugins here too, so that the new connection dialog
+	 * doesn't stall on loading all of them the first time it's opened.
+	 * Nothing else touches the list until the thread is joined. */
+	for (iter = plugins; iter; iter = iter->next)
+		vpn_get_editor_plugin (iter->data);
+
+	/* sort the list of plugins alphabetically. */
+	return g_slist_sort (plugins, (GCompareFunc) _sort_vpn_plugins);
+}
+
+/**
+ * vpn_plugin_infos_preload:
+ *
+ * Starts reading the VPN plugin descriptions and loading their editor
+ * plugins in a worker thread so that the first vpn_get_plugin_infos() call
+ * doesn't have to wait for it.
+ */
+void
+vpn_plugin_infos_preload (void)
+{
+	static gboolean started = FALSE;
+
+	if (started)
+		return;
+	started = TRUE;
+
+	plugin_infos_thread = g_thread_new ("vpn-plugin-infos", load_plugin_infos, NULL);
+}
+
+/**
+ * vpn_get_plugin_infos:
+ *
+ * Returns: (transfer none): the sorted list of installed VPN plugins.
+ *   Their editor plugins are already loaded; vpn_get_editor_plugin()
+ *   returns them.
+ */
 GSList *
 vpn_get_plugin_infos (void)
 {
 	static gboolean plugins_loaded = FALSE;
 	static GSList *plugins = NULL;
-	GSList *p;
 
 	if (G_LIKELY (plugins_loaded))
 		return plugins;
 	plugins_loaded = TRUE;
 
-	p = nm_vpn_plugin_info_list_load ();
-	plugins = NULL;
-	while (p) {
-		NMVpnPluginInfo *plugin_info = NM_VPN_PLUGIN_INFO (p->data);
-		GError *error = NULL;
-
-		/* load the editor plugin, and preserve only those NMVpnPluginInfo that can
-		 * successfully load the plugin. */
-		if (nm_vpn_plugin_info_load_editor_plugin (plugin_info, &error)) {
-			plugins = g_slist_prepend (plugins, plugin_info);
-			g_info ("vpn: (%s,%s) loaded",
-			        nm_vpn_plugin_info_get_name (plugin_info),
-			        nm_vpn_plugin_info_get_filename (plugin_info));
-		} else {
-			if (   !nm_vpn_plugin_info_get_plugin (plugin_info)
-			    && nm_vpn_plugin_info_lookup_property (plugin_info, NM_VPN_PLUGIN_INFO_KF_GROUP_GNOME, "properties")) {
-				g_message ("vpn: (%s,%s) cannot load legacy-only plugin",
-				           nm_vpn_plugin_info_get_name (plugin_info),
-				           nm_vpn_plugin_info_get_filename (plugin_info));
-			} else {
-				g_warning ("vpn: (%s,%s) could not load plugin: %s",
-				           nm_vpn_plugin_info_get_name (plugin_info),
-				           nm_vpn_plugin_info_get_filename (plugin_info),
-				           error->message);
-			}
-			g_clear_error (&error);
-			g_object_unref (plugin_info);
-		}
-		p = g_slist_delete_link (p, p);
-	}
-
-	/* sort the list of plugins alphabetically. */
-	plugins = g_slist_sort (plugins, (GCompareFunc) _sort_vpn_plugins);
+	vpn_plugin_infos_preload ();
+	plugins = g_thread_join (g_steal_pointer (&plugin_infos_thread));
 	return plugins;
 }
 
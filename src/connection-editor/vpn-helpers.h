@@ -14,8 +14,12 @@
 
 #include <NetworkManager.h>
 
+void vpn_plugin_infos_preload (void);
+
 GSList *vpn_get_plugin_infos (void);
 
+NMVpnEditorPlugin *vpn_get_editor_plugin (NMVpnPluginInfo *plugin_info);
+
 NMVpnEditorPlugin *vpn_get_plugin_by_service (const char *service);
 
 void vpn_export (NMConnection *connection);
@@ -362,6 +362,88 @@ widget_unset_error (GtkWidget *widget)
 	gtk_style_context_remove_class (gtk_widget_get_style_context (widget), "error");
 }
 
+/* The checks behind the utils_tree_model_get_*() functions, on the cell
+ * text itself; usable where the model is out of reach. */
+gboolean
+utils_str_get_int64 (const char *str,
+                     gint64 min_value,
+                     gint64 max_value,
+                     gboolean fail_if_missing,
+                     gint64 *out)
+{
+	gint64 val;
+
+	if (!str || !str[0])
+		return !fail_if_missing;
+
+	val = _nm_utils_ascii_str_to_int64 (str, 10, min_value, max_value, 0);
+	if (errno)
+		return FALSE;
+
+	*out = val;
+	return TRUE;
+}
+
+/* Sets @out to @str if it holds an address; an unspecified address counts
+ * as a missing one. */
+gboolean
+utils_str_get_address (const char *str,
+                       int family,
+                       gboolean fail_if_missing,
+                       const char **out)
+{
+	union {
+		struct in_addr addr4;
+		struct in6_addr addr6;
+	} tmp_addr;
+
+	g_return_val_if_fail (family == AF_INET || family == AF_INET6, FALSE);
+
+	if (!str || !str[0])
+		return !fail_if_missing;
+
+	if (inet_pton (family, str, &tmp_addr) <= 0)
+		return FALSE;
+
+	if (   (family == AF_INET && tmp_addr.addr4.s_addr == 0)
+	    || (family == AF_INET6 && IN6_IS_ADDR_UNSPECIFIED (&tmp_addr.addr6)))
+		return !fail_if_missing;
+
+	*out = str;
+	return TRUE;
+}
+
+gboolean
+utils_str_get_ip4_prefix (const char *str,
+                          gboolean fail_if_missing,
+                          guint32 *out)
+{
+	struct in_addr tmp_addr = { 0 };
+	glong tmp_prefix;
+
+	if (!str || !str[0])
+		return !fail_if_missing;
+
+	errno = 0;
+
+	/* Is it a prefix? */
+	if (!strchr (str, '.')) {
+		tmp_prefix = strtol (str, NULL, 10);
+		if (!errno && tmp_prefix >= 0 && tmp_prefix <= 32) {
+			*out = tmp_prefix;
+			return TRUE;
+		}
+	}
+
+	/* Is it a netmask? */
+	if (inet_pton (AF_INET, str, &tmp_addr) > 0) {
+		*out = nm_utils_ip4_netmask_to_prefix (tmp_addr.s_addr);
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
 gboolean
 utils_tree_model_get_int64 (GtkTreeModel *model,
                             GtkTreeIter *iter,
@@ -373,29 +455,17 @@ utils_tree_model_get_int64 (GtkTreeModel *model,
                             char **out_raw)
 {
 	char *item = NULL;
-	gboolean success = FALSE;
-	gint64 val;
+	gboolean success;
 
 	g_return_val_if_fail (model, FALSE);
 	g_return_val_if_fail (iter, FALSE);
 
 	gtk_tree_model_get (model, iter, column, &item, -1);
+	success = utils_str_get_int64 (item, min_value, max_value, fail_if_missing, out);
+
 	if (out_raw)
 		*out_raw = item;
-	if (!item || !strlen (item)) {
-		if (!out_raw)
-			g_free (item);
-		return fail_if_missing ? FALSE : TRUE;
-	}
-
-	val = _nm_utils_ascii_str_to_int64 (item, 10, min_value, max_value, 0);
-	if (errno)
-		goto out;
-
-	*out = val;
-	success = TRUE;
-out:
-	if (!out_raw)
+	else
 		g_free (item);
 	return success;
 }
@@ -410,36 +480,23 @@ utils_tree_model_get_address (GtkTreeModel *model,
                               char **out_raw)
 {
 	char *item = NULL;
-	union {
-		struct in_addr addr4;
-		struct in6_addr addr6;
-	} tmp_addr;
+	const char *addr = NULL;
+	gboolean success;
 
 	g_return_val_if_fail (model, FALSE);
 	g_return_val_if_fail (iter, FALSE);
 	g_return_val_if_fail (family == AF_INET || family == AF_INET6, FALSE);
 
 	gtk_tree_model_get (model, iter, column, &item, -1);
+	success = utils_str_get_address (item, family, fail_if_missing, &addr);
+
 	if (out_raw)
 		*out_raw = item;
-	if (!item || !strlen (item)) {
-		if (!out_raw)
-			g_free (item);
-		return fail_if_missing ? FALSE : TRUE;
-	}
-
-	if (inet_pton (family, item, &tmp_addr) == 0)
-		return FALSE;
-
-	if (   (family == AF_INET && tmp_addr.addr4.s_addr == 0)
-	    || (family == AF_INET6 && IN6_IS_ADDR_UNSPECIFIED (&tmp_addr.addr6))) {
-		if (!out_raw)
-			g_free (item);
-		return fail_if_missing ? FALSE : TRUE;
-	}
-
-	*out = item;
-	return TRUE;
+	if (addr)
+		*out = item;
+	else if (!out_raw)
+		g_free (item);
+	return success;
 }
 
 gboolean
@@ -451,42 +508,17 @@ utils_tree_model_get_ip4_prefix (GtkTreeModel *model,
                                  char **out_raw)
 {
 	char *item = NULL;
-	struct in_addr tmp_addr = { 0 };
-	gboolean success = FALSE;
-	glong tmp_prefix;
+	gboolean success;
 
 	g_return_val_if_fail (model, FALSE);
 	g_return_val_if_fail (iter, FALSE);
 
 	gtk_tree_model_get (model, iter, column, &item, -1);
+	success = utils_str_get_ip4_prefix (item, fail_if_missing, out);
+
 	if (out_raw)
 		*out_raw = item;
-	if (!item || !strlen (item)) {
-		if (!out_raw)
-			g_free (item);
-		return fail_if_missing ? FALSE : TRUE;
-	}
-
-	errno = 0;
-
-	/* Is it a prefix? */
-	if (!strchr (item, '.')) {
-		tmp_prefix = strtol (item, NULL, 10);
-		if (!errno && tmp_prefix >= 0 && tmp_prefix <= 32) {
-			*out = tmp_prefix;
-			success = TRUE;
-			goto out;
-		}
-	}
-
-	/* Is it a netmask? */
-	if (inet_pton (AF_INET, item, &tmp_addr) > 0) {
-		*out = nm_utils_ip4_netmask_to_prefix (tmp_addr.s_addr);
-		success = TRUE;
-	}
-
-out:
-	if (!out_raw)
+	else
 		g_free (item);
 	return success;
 }
@@ -60,6 +60,21 @@ void utils_set_cell_background (GtkCellRenderer *cell,
 void widget_set_error   (GtkWidget *widget);
 void widget_unset_error (GtkWidget *widget);
 
+gboolean utils_str_get_int64 (const char *str,
+                              gint64 min_value,
+                              gint64 max_value,
+                              gboolean fail_if_missing,
+                              gint64 *out);
+
+gboolean utils_str_get_address (const char *str,
+                                int family,
+                                gboolean fail_if_missing,
+                                const char **out);
+
+gboolean utils_str_get_ip4_prefix (const char *str,
+                                   gboolean fail_if_missing,
+                                   guint32 *out);
+
 gboolean utils_tree_model_get_int64 (GtkTreeModel *model,
                                      GtkTreeIter *iter,
                                      int column,